@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Minimal in-tree benchmark harness. A benchmark is a function of the input
+// size that prepares its data, brackets the measured region with
+// state.start()/state.stop() and feeds results to do_not_optimize(). The
+// runner warms each case up, repeats it until a time budget is met and
+// reports the median and p99 of the per-element cost as JSON.
+namespace bench {
+
+// Forces `value` to be materialised so the measured work cannot be removed
+// as dead code.
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Tells the compiler that all memory may have been read and written.
+inline void clobber_memory() {
+#if defined(__GNUC__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+class state {
+public:
+    explicit state(std::size_t size) : size(size), items(size) {}
+
+    void start() { begin_ = std::chrono::steady_clock::now(); }
+    void stop() { elapsed_ += std::chrono::steady_clock::now() - begin_; }
+    double elapsed_ns() const { return std::chrono::duration<double, std::nano>(elapsed_).count(); }
+
+    // Input size for this run and the number of operations the measured region
+    // performs (defaults to size; ns/op and items/sec are derived from it).
+    const std::size_t size;
+    std::size_t items;
+
+private:
+    std::chrono::steady_clock::time_point begin_;
+    std::chrono::steady_clock::duration elapsed_{};
+};
+
+using function = std::function<void(state&)>;
+
+struct registration {
+    registration(const char* name, function fn);
+};
+
+// Deterministic input data shared by the benchmark files.
+inline std::vector<int> random_ints(std::size_t n, int lo, int hi, std::uint32_t seed = 42) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(lo, hi);
+    std::vector<int> values(n);
+    for (auto& v : values) v = dist(rng);
+    return values;
+}
+
+}  // namespace bench
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+#define BENCHMARK(name, fn) static ::bench::registration BENCH_CONCAT(bench_reg_, __LINE__)(name, fn)
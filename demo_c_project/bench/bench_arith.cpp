@@ -0,0 +1,90 @@
+#include <vector>
+#include "bench.h"
+#include "calculator.h"
+
+namespace {
+
+struct operands {
+    explicit operands(std::size_t n)
+        : a(bench::random_ints(n, -100000, 100000, 1)),
+          b(bench::random_ints(n, 1, 1000, 2)),
+          out(n) {}
+    std::vector<int> a, b, out;
+};
+
+// Scalar calls into calculator.c in a loop, the baseline for the kernels.
+void scalar_add(bench::state& st) {
+    operands x(st.size);
+    st.start();
+    for (std::size_t i = 0; i < st.size; ++i) x.out[i] = add(x.a[i], x.b[i]);
+    st.stop();
+    bench::do_not_optimize(x.out.back());
+}
+
+void scalar_multiply(bench::state& st) {
+    operands x(st.size);
+    st.start();
+    for (std::size_t i = 0; i < st.size; ++i) x.out[i] = multiply(x.a[i], x.b[i]);
+    st.stop();
+    bench::do_not_optimize(x.out.back());
+}
+
+void scalar_divide(bench::state& st) {
+    operands x(st.size);
+    int err = 0;
+    st.start();
+    for (std::size_t i = 0; i < st.size; ++i) x.out[i] = divide(x.a[i], x.b[i], &err);
+    st.stop();
+    bench::do_not_optimize(x.out.back());
+}
+
+template <void (*Kernel)(const int*, const int*, int*, size_t)>
+void array_kernel(bench::state& st) {
+    operands x(st.size);
+    st.start();
+    Kernel(x.a.data(), x.b.data(), x.out.data(), st.size);
+    st.stop();
+    bench::do_not_optimize(x.out.back());
+}
+
+template <int (*Kernel)(const int*, const int*, int*, size_t)>
+void checked_kernel(bench::state& st) {
+    operands x(st.size);
+    st.start();
+    int flag = Kernel(x.a.data(), x.b.data(), x.out.data(), st.size);
+    st.stop();
+    bench::do_not_optimize(flag);
+    bench::do_not_optimize(x.out.back());
+}
+
+void divide_per_element(bench::state& st) {
+    operands x(st.size);
+    st.start();
+    int flag = divide_n(x.a.data(), x.b.data(), x.out.data(), nullptr, st.size);
+    st.stop();
+    bench::do_not_optimize(flag);
+    bench::do_not_optimize(x.out.back());
+}
+
+void divide_prepared(bench::state& st) {
+    operands x(st.size);
+    calc_divisor_t d;
+    calc_divisor_prepare(&d, 7);
+    st.start();
+    divide_prepared_n(x.a.data(), &d, x.out.data(), st.size);
+    st.stop();
+    bench::do_not_optimize(x.out.back());
+}
+
+}  // namespace
+
+BENCHMARK("arith/scalar_add", scalar_add);
+BENCHMARK("arith/scalar_multiply", scalar_multiply);
+BENCHMARK("arith/scalar_divide", scalar_divide);
+BENCHMARK("arith/add_n", array_kernel<add_n>);
+BENCHMARK("arith/subtract_n", array_kernel<subtract_n>);
+BENCHMARK("arith/multiply_n", array_kernel<multiply_n>);
+BENCHMARK("arith/add_checked_n", checked_kernel<add_checked_n>);
+BENCHMARK("arith/multiply_sat_n", checked_kernel<multiply_sat_n>);
+BENCHMARK("arith/divide_n", divide_per_element);
+BENCHMARK("arith/divide_prepared_n", divide_prepared);
@@ -0,0 +1,73 @@
+// The ways of evaluating "(a*b + c) % m" over a batch of rows: bytecode per
+// row, bytecode over columns, closure-compiled and the compile-time template.
+#include <vector>
+#include "bench.h"
+#include "calc_expr.h"
+#include "calc_expr.hpp"
+
+namespace {
+
+struct inputs {
+    explicit inputs(std::size_t n) : out(n), bits((n + 7) / 8), rows(n * 4) {
+        for (int v = 0; v < 4; ++v) {
+            cols[v] = bench::random_ints(n, v == 3 ? 1 : 0, 1000, v + 10);
+            columns[v] = cols[v].data();
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            for (int v = 0; v < 4; ++v) rows[i * 4 + v] = cols[v][i];
+        }
+        expr = calc_expr_compile("(a*b + c) % m", nullptr, 0);
+    }
+    ~inputs() { calc_expr_destroy(expr); }
+
+    std::vector<int> cols[4];
+    const int* columns[4];
+    std::vector<int> out;
+    std::vector<unsigned char> bits;
+    std::vector<int> rows;
+    calc_expr_t* expr;
+};
+
+void bytecode_row(bench::state& st) {
+    inputs in(st.size);
+    int err = 0;
+    st.start();
+    for (std::size_t i = 0; i < st.size; ++i) in.out[i] = calc_expr_eval(in.expr, &in.rows[i * 4], &err);
+    st.stop();
+    bench::do_not_optimize(in.out.back());
+}
+
+void bytecode_columns(bench::state& st) {
+    inputs in(st.size);
+    st.start();
+    calc_expr_eval_n(in.expr, in.columns, in.out.data(), in.bits.data(), st.size);
+    st.stop();
+    bench::do_not_optimize(in.out.back());
+}
+
+void closure_columns(bench::state& st) {
+    inputs in(st.size);
+    calc_expr_closure_t* closure = calc_expr_closure_compile(in.expr);
+    st.start();
+    calc_expr_closure_eval_n(closure, in.columns, in.out.data(), in.bits.data(), st.size);
+    st.stop();
+    bench::do_not_optimize(in.out.back());
+    calc_expr_closure_destroy(closure);
+}
+
+void template_columns(bench::state& st) {
+    using namespace calc;
+    inputs in(st.size);
+    auto rule = (var<0>() * var<1>() + var<2>()) % var<3>();
+    st.start();
+    rule.eval_n(in.columns, in.out.data(), in.bits.data(), st.size);
+    st.stop();
+    bench::do_not_optimize(in.out.back());
+}
+
+}  // namespace
+
+BENCHMARK("expr/bytecode_row", bytecode_row);
+BENCHMARK("expr/bytecode_columns", bytecode_columns);
+BENCHMARK("expr/closure_columns", closure_columns);
+BENCHMARK("expr/template_columns", template_columns);
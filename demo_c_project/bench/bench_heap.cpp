@@ -0,0 +1,183 @@
+#include <vector>
+#include "bench.h"
+#include "calculator.h"
+#include "dary_heap.h"
+#include "heap_merge.h"
+#include "kv_heap.h"
+#include "radix_heap.h"
+#include "typed_heap.h"
+
+namespace {
+
+void legacy_insert(bench::state& st) {
+    std::vector<int> values = bench::random_ints(st.size, 0, 1 << 30);
+    int* heap = nullptr;
+    int size = 0, capacity = 0;
+    st.start();
+    for (int v : values) min_heap_insert(&heap, &size, &capacity, v);
+    st.stop();
+    bench::do_not_optimize(heap[0]);
+    destroy_queue(&heap, &size, &capacity);
+}
+
+void legacy_delete_min(bench::state& st) {
+    std::vector<int> values = bench::random_ints(st.size, 0, 1 << 30);
+    int* heap = nullptr;
+    int size = 0, capacity = 0;
+    min_heap_build(&heap, &size, &capacity, values.data(), static_cast<int>(values.size()));
+    st.start();
+    while (size > 0) bench::do_not_optimize(min_heap_delete_min(&heap, &size));
+    st.stop();
+    destroy_queue(&heap, &size, &capacity);
+}
+
+void legacy_build(bench::state& st) {
+    std::vector<int> values = bench::random_ints(st.size, 0, 1 << 30);
+    int* heap = nullptr;
+    int size = 0, capacity = 0;
+    st.start();
+    min_heap_build(&heap, &size, &capacity, values.data(), static_cast<int>(values.size()));
+    st.stop();
+    bench::do_not_optimize(heap[0]);
+    destroy_queue(&heap, &size, &capacity);
+}
+
+void heap_push_pop(bench::state& st) {
+    std::vector<int> values = bench::random_ints(st.size, 0, 1 << 30);
+    min_heap_t heap;
+    min_heap_init(&heap, static_cast<int>(st.size), nullptr);
+    st.items = 2 * st.size;
+    st.start();
+    for (int v : values) min_heap_push(&heap, v);
+    int out;
+    while (min_heap_pop(&heap, &out) == 0) bench::do_not_optimize(out);
+    st.stop();
+    min_heap_destroy(&heap);
+}
+
+template <void (*Insert)(int**, int*, int*, int), int (*DeleteMin)(int**, int*),
+          void (*Destroy)(int**, int*, int*)>
+void dary_push_pop(bench::state& st) {
+    std::vector<int> values = bench::random_ints(st.size, 0, 1 << 30);
+    int* heap = nullptr;
+    int size = 0, capacity = 0;
+    st.items = 2 * st.size;
+    st.start();
+    for (int v : values) Insert(&heap, &size, &capacity, v);
+    while (size > 0) bench::do_not_optimize(DeleteMin(&heap, &size));
+    st.stop();
+    Destroy(&heap, &size, &capacity);
+}
+
+// Struct-of-arrays versus packed 64-bit entries for (key, payload) records.
+void kv_soa_push_pop(bench::state& st) {
+    std::vector<int> keys = bench::random_ints(st.size, -(1 << 30), 1 << 30);
+    kv_heap_t heap;
+    kv_heap_init(&heap, static_cast<int>(st.size));
+    st.items = 2 * st.size;
+    st.start();
+    for (int k : keys) kv_heap_push(&heap, k, &heap);
+    int key;
+    void* payload;
+    while (kv_heap_pop(&heap, &key, &payload) == 0) bench::do_not_optimize(key);
+    st.stop();
+    kv_heap_destroy(&heap);
+}
+
+void kv_packed_push_pop(bench::state& st) {
+    std::vector<int> keys = bench::random_ints(st.size, -(1 << 30), 1 << 30);
+    kv_packed_heap_t heap;
+    kv_packed_heap_init(&heap, static_cast<int>(st.size));
+    st.items = 2 * st.size;
+    st.start();
+    for (int k : keys) kv_packed_heap_push(&heap, k, &heap);
+    int key;
+    void* payload;
+    while (kv_packed_heap_pop(&heap, &key, &payload) == 0) bench::do_not_optimize(key);
+    st.stop();
+    kv_packed_heap_destroy(&heap);
+}
+
+// Typed heap with the comparator inlined, on the same int keys as heap_push_pop.
+void typed_i64_push_pop(bench::state& st) {
+    std::vector<int> values = bench::random_ints(st.size, 0, 1 << 30);
+    i64_min_heap_t heap;
+    i64_min_heap_init(&heap, static_cast<int>(st.size));
+    st.items = 2 * st.size;
+    st.start();
+    for (int v : values) i64_min_heap_push(&heap, v);
+    int64_t out;
+    while (i64_min_heap_pop(&heap, &out) == 0) bench::do_not_optimize(out);
+    st.stop();
+    i64_min_heap_destroy(&heap);
+}
+
+// Monotone workload (pop the minimum, push it plus a delta below Range) on the
+// radix heap versus min_heap_t; compare the two at each key range to pick one.
+template <int Range>
+void monotone_radix(bench::state& st) {
+    std::vector<int> keys = bench::random_ints(st.size, 0, Range - 1);
+    std::vector<int> deltas = bench::random_ints(st.size, 0, Range - 1, 7);
+    radix_heap_t heap;
+    radix_heap_init(&heap);
+    for (int k : keys) radix_heap_push(&heap, k);
+    st.items = 2 * st.size;
+    st.start();
+    int key;
+    for (int d : deltas) {
+        radix_heap_pop(&heap, &key);
+        radix_heap_push(&heap, key + d);
+    }
+    st.stop();
+    bench::do_not_optimize(key);
+    radix_heap_destroy(&heap);
+}
+
+template <int Range>
+void monotone_binary(bench::state& st) {
+    std::vector<int> keys = bench::random_ints(st.size, 0, Range - 1);
+    std::vector<int> deltas = bench::random_ints(st.size, 0, Range - 1, 7);
+    min_heap_t heap;
+    min_heap_init(&heap, static_cast<int>(st.size), nullptr);
+    min_heap_push_many(&heap, keys.data(), static_cast<int>(keys.size()));
+    st.items = 2 * st.size;
+    st.start();
+    int key;
+    for (int d : deltas) {
+        min_heap_pop(&heap, &key);
+        min_heap_push(&heap, key + d);
+    }
+    st.stop();
+    bench::do_not_optimize(key);
+    min_heap_destroy(&heap);
+}
+
+// Whole-array sort: one thread through heap_parallel_sort versus all cores.
+template <int Threads>
+void parallel_sort(bench::state& st) {
+    std::vector<int> values = bench::random_ints(st.size, 0, 1 << 30);
+    st.start();
+    heap_parallel_sort(values.data(), values.size(), Threads);
+    st.stop();
+    bench::do_not_optimize(values[0]);
+}
+
+}  // namespace
+
+BENCHMARK("heap/min_heap_insert", legacy_insert);
+BENCHMARK("heap/min_heap_delete_min", legacy_delete_min);
+BENCHMARK("heap/min_heap_build", legacy_build);
+BENCHMARK("heap/min_heap_push_pop", heap_push_pop);
+BENCHMARK("heap/dary4_push_pop", (dary_push_pop<dary4_heap_insert, dary4_heap_delete_min, dary4_destroy_queue>));
+BENCHMARK("heap/dary8_push_pop", (dary_push_pop<dary8_heap_insert, dary8_heap_delete_min, dary8_destroy_queue>));
+BENCHMARK("heap/typed_i64_push_pop", typed_i64_push_pop);
+BENCHMARK("heap/kv_soa_push_pop", kv_soa_push_pop);
+BENCHMARK("heap/kv_packed_push_pop", kv_packed_push_pop);
+BENCHMARK("heap/monotone/range=1e2/radix", monotone_radix<100>);
+BENCHMARK("heap/monotone/range=1e2/binary", monotone_binary<100>);
+BENCHMARK("heap/monotone/range=1e4/radix", monotone_radix<10000>);
+BENCHMARK("heap/monotone/range=1e4/binary", monotone_binary<10000>);
+BENCHMARK("heap/monotone/range=1e6/radix", monotone_radix<1000000>);
+BENCHMARK("heap/monotone/range=1e6/binary", monotone_binary<1000000>);
+BENCHMARK("heap/parallel_sort/threads=1", parallel_sort<1>);
+BENCHMARK("heap/parallel_sort/threads=all", parallel_sort<0>);
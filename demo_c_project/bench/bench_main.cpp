@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "cpu_features.h"
+
+#ifndef BENCH_PROFILE
+#define BENCH_PROFILE "unknown"
+#endif
+
+namespace bench {
+namespace {
+
+struct entry {
+    const char* name;
+    function fn;
+};
+
+std::vector<entry>& registry() {
+    static std::vector<entry> entries;
+    return entries;
+}
+
+struct options {
+    double min_time_s = 0.1;
+    int warmup = 1;
+    int min_reps = 5;
+    int max_reps = 1000;
+    std::size_t min_size = 100;
+    std::size_t max_size = 1000000;
+    std::string filter;
+    std::string json_path;
+};
+
+struct result {
+    std::string name;
+    std::size_t size;
+    std::size_t items;
+    int reps;
+    double median_ns;
+    double p99_ns;
+    double min_ns;
+    double mean_ns;
+};
+
+double run_once(const function& fn, std::size_t size, std::size_t* items) {
+    state st(size);
+    fn(st);
+    *items = st.items;
+    return st.elapsed_ns();
+}
+
+result measure(const entry& e, std::size_t size, const options& opt) {
+    std::size_t items = size;
+    double first = 0;
+    for (int i = 0; i < std::max(opt.warmup, 1); ++i) first = run_once(e.fn, size, &items);
+    int reps = opt.min_reps;
+    if (first > 0) {
+        double wanted = opt.min_time_s * 1e9 / first;
+        reps = static_cast<int>(std::min<double>(std::max<double>(wanted, opt.min_reps), opt.max_reps));
+    }
+    std::vector<double> per_op;
+    per_op.reserve(reps);
+    for (int r = 0; r < reps; ++r) {
+        double ns = run_once(e.fn, size, &items);
+        per_op.push_back(ns / static_cast<double>(items ? items : 1));
+    }
+    std::sort(per_op.begin(), per_op.end());
+    result res;
+    res.name = e.name;
+    res.size = size;
+    res.items = items;
+    res.reps = reps;
+    res.median_ns = per_op[per_op.size() / 2];
+    res.p99_ns = per_op[std::min(per_op.size() - 1, per_op.size() * 99 / 100)];
+    res.min_ns = per_op.front();
+    double sum = 0;
+    for (double v : per_op) sum += v;
+    res.mean_ns = sum / per_op.size();
+    return res;
+}
+
+void write_json(std::FILE* out, const std::vector<result>& results) {
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    std::fprintf(out, "{\n  \"context\": {\"date\": \"%s\", \"profile\": \"%s\", \"cpu_features\": %u},\n", date,
+                 BENCH_PROFILE, cpu_features());
+    std::fprintf(out, "  \"benchmarks\": [\n");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const result& r = results[i];
+        std::fprintf(out,
+                     "    {\"name\": \"%s\", \"size\": %zu, \"items\": %zu, \"repetitions\": %d, "
+                     "\"median_ns_per_op\": %.4f, \"p99_ns_per_op\": %.4f, \"min_ns_per_op\": %.4f, "
+                     "\"mean_ns_per_op\": %.4f, \"items_per_second\": %.1f}%s\n",
+                     r.name.c_str(), r.size, r.items, r.reps, r.median_ns, r.p99_ns, r.min_ns, r.mean_ns,
+                     r.median_ns > 0 ? 1e9 / r.median_ns : 0.0, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+}
+
+// Negative and fractional values clamp to 0; callers apply their own minimum.
+std::size_t parse_size(const char* s) {
+    double d = std::strtod(s, nullptr);
+    return d >= 1 ? static_cast<std::size_t>(d) : 0;
+}
+
+bool parse_flag(const char* arg, const char* name, const char** value) {
+    std::size_t len = std::strlen(name);
+    if (std::strncmp(arg, name, len) != 0 || arg[len] != '=') return false;
+    *value = arg + len + 1;
+    return true;
+}
+
+}  // namespace
+
+registration::registration(const char* name, function fn) {
+    registry().push_back(entry{name, std::move(fn)});
+}
+
+}  // namespace bench
+
+int main(int argc, char** argv) {
+    using namespace bench;
+    options opt;
+    for (int i = 1; i < argc; ++i) {
+        const char* v = nullptr;
+        if (parse_flag(argv[i], "--min_time", &v)) {
+            opt.min_time_s = std::strtod(v, nullptr);
+        } else if (parse_flag(argv[i], "--warmup", &v)) {
+            opt.warmup = std::atoi(v);
+        } else if (parse_flag(argv[i], "--min_reps", &v)) {
+            opt.min_reps = std::max(1, std::atoi(v));
+        } else if (parse_flag(argv[i], "--max_reps", &v)) {
+            opt.max_reps = std::max(1, std::atoi(v));
+        } else if (parse_flag(argv[i], "--min_size", &v)) {
+            // The size sweep multiplies by 10, so 0 would never advance.
+            opt.min_size = std::max<std::size_t>(1, parse_size(v));
+        } else if (parse_flag(argv[i], "--max_size", &v)) {
+            opt.max_size = parse_size(v);
+        } else if (parse_flag(argv[i], "--filter", &v)) {
+            opt.filter = v;
+        } else if (parse_flag(argv[i], "--json", &v)) {
+            opt.json_path = v;
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--filter=substr] [--min_size=1e2] [--max_size=1e6] [--min_time=0.1] "
+                         "[--warmup=1] [--min_reps=5] [--max_reps=1000] [--json=path]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+    opt.max_reps = std::max(opt.max_reps, opt.min_reps);
+
+    std::vector<result> results;
+    std::fprintf(stderr, "%-36s %10s %12s %12s %14s\n", "benchmark", "size", "median ns", "p99 ns", "items/s");
+    for (const auto& e : registry()) {
+        if (!opt.filter.empty() && std::strstr(e.name, opt.filter.c_str()) == nullptr) continue;
+        for (std::size_t size = opt.min_size; size <= opt.max_size; size *= 10) {
+            result r = measure(e, size, opt);
+            std::fprintf(stderr, "%-36s %10zu %12.3f %12.3f %14.4g\n", r.name.c_str(), r.size, r.median_ns,
+                         r.p99_ns, r.median_ns > 0 ? 1e9 / r.median_ns : 0.0);
+            results.push_back(r);
+            if (size > opt.max_size / 10) break;
+        }
+    }
+
+    if (opt.json_path.empty()) {
+        write_json(stdout, results);
+    } else {
+        std::FILE* out = std::fopen(opt.json_path.c_str(), "w");
+        if (!out) {
+            std::perror(opt.json_path.c_str());
+            return 1;
+        }
+        write_json(out, results);
+        std::fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "calculator.h"
+#include "multi_queue.h"
+
+namespace {
+
+// Each of Threads threads runs size / Threads push+pop pairs against one shared
+// queue; ns/op falling with the thread count is the scaling being measured.
+// Threads are started before the clock and released together.
+template <typename Queue>
+void run_threads(bench::state& st, unsigned threads, Queue& queue) {
+    std::vector<int> values = bench::random_ints(st.size, 0, 1 << 30);
+    std::size_t per_thread = st.size / threads;
+    st.items = 2 * per_thread * threads;
+    std::atomic<bool> go{false};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            const int* v = values.data() + t * per_thread;
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                queue.push(v[i]);
+                bench::do_not_optimize(queue.pop());
+            }
+        });
+    }
+    st.start();
+    go.store(true, std::memory_order_release);
+    for (std::thread& th : pool) th.join();
+    st.stop();
+}
+
+struct relaxed_queue {
+    relaxed_queue() : q(multi_queue_create(0)) {
+        for (int i = 0; i < 1024; ++i) multi_queue_push(q, i);
+    }
+    ~relaxed_queue() { multi_queue_destroy(q); }
+    void push(int v) { multi_queue_push(q, v); }
+    int pop() {
+        int out = 0;
+        multi_queue_pop(q, &out);
+        return out;
+    }
+    multi_queue_int_t* q;
+};
+
+// Baseline: one min_heap_t behind a single mutex.
+struct locked_heap {
+    locked_heap() {
+        min_heap_init(&heap, 0, nullptr);
+        for (int i = 0; i < 1024; ++i) min_heap_push(&heap, i);
+    }
+    ~locked_heap() { min_heap_destroy(&heap); }
+    void push(int v) {
+        std::lock_guard<std::mutex> guard(lock);
+        min_heap_push(&heap, v);
+    }
+    int pop() {
+        std::lock_guard<std::mutex> guard(lock);
+        int out = 0;
+        min_heap_pop(&heap, &out);
+        return out;
+    }
+    std::mutex lock;
+    min_heap_t heap;
+};
+
+template <typename Queue, unsigned Threads>
+void concurrent_push_pop(bench::state& st) {
+    Queue queue;
+    run_threads(st, Threads, queue);
+}
+
+}  // namespace
+
+BENCHMARK("heap/multi_queue/threads=1", (concurrent_push_pop<relaxed_queue, 1>));
+BENCHMARK("heap/multi_queue/threads=2", (concurrent_push_pop<relaxed_queue, 2>));
+BENCHMARK("heap/multi_queue/threads=4", (concurrent_push_pop<relaxed_queue, 4>));
+BENCHMARK("heap/multi_queue/threads=8", (concurrent_push_pop<relaxed_queue, 8>));
+BENCHMARK("heap/multi_queue/threads=16", (concurrent_push_pop<relaxed_queue, 16>));
+BENCHMARK("heap/locked_min_heap/threads=1", (concurrent_push_pop<locked_heap, 1>));
+BENCHMARK("heap/locked_min_heap/threads=2", (concurrent_push_pop<locked_heap, 2>));
+BENCHMARK("heap/locked_min_heap/threads=4", (concurrent_push_pop<locked_heap, 4>));
+BENCHMARK("heap/locked_min_heap/threads=8", (concurrent_push_pop<locked_heap, 8>));
+BENCHMARK("heap/locked_min_heap/threads=16", (concurrent_push_pop<locked_heap, 16>));
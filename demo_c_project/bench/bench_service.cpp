@@ -0,0 +1,46 @@
+#include <vector>
+#include "bench.h"
+#include "calc_service.h"
+#include "calculator.h"
+
+namespace {
+
+// Synchronous baseline: one divide() call per request on the caller's thread.
+void direct_divide(bench::state& st) {
+    std::vector<int> a = bench::random_ints(st.size, -(1 << 30), 1 << 30);
+    std::vector<int> b = bench::random_ints(st.size, -100, 100, 7);
+    st.start();
+    for (std::size_t i = 0; i < st.size; ++i) {
+        int error;
+        bench::do_not_optimize(divide(a[i], b[i], &error));
+    }
+    st.stop();
+}
+
+// The same requests through one client of a single-worker service, including
+// submission, batching and reaping.
+void service_divide(bench::state& st) {
+    std::vector<int> a = bench::random_ints(st.size, -(1 << 30), 1 << 30);
+    std::vector<int> b = bench::random_ints(st.size, -100, 100, 7);
+    std::vector<calc_sqe_t> sqes(st.size);
+    for (std::size_t i = 0; i < st.size; ++i) sqes[i] = {CALC_SVC_OP_DIVIDE, a[i], b[i], i};
+    calc_service_t* service = calc_service_create(1, 0);
+    calc_client_t* client = calc_client_create(service, 1024);
+    std::vector<calc_cqe_t> cqes(1024);
+    int total = static_cast<int>(st.size);
+    st.start();
+    int submitted = 0, completed = 0;
+    while (completed < total) {
+        submitted += calc_client_submit(client, sqes.data() + submitted, total - submitted);
+        completed += calc_client_wait(client, cqes.data(), 1024, 1);
+    }
+    st.stop();
+    bench::do_not_optimize(cqes[0]);
+    calc_client_destroy(client);
+    calc_service_destroy(service);
+}
+
+}  // namespace
+
+BENCHMARK("service/direct_divide", direct_divide);
+BENCHMARK("service/ring_divide", service_divide);
@@ -1,10 +1,31 @@
 import argparse
+import hashlib
 import os
+import shlex
 import shutil
 import subprocess
 import sys
+import threading
+from concurrent.futures import ThreadPoolExecutor
 from pathlib import Path
-from typing import List
+from typing import List, Optional, Sequence
+
+# Compiler flags per build profile, mirroring the Makefile. Every profile but
+# debug builds into its own build-<profile> directory.
+PROFILES = {
+    "debug": ["-g"],
+    "release": ["-O2", "-DNDEBUG"],
+    "relwithdebinfo": ["-O2", "-g", "-DNDEBUG"],
+    "native": ["-O3", "-march=native", "-DNDEBUG"],
+    "pgo": ["-O2", "-DNDEBUG"],
+}
+MSVC_PROFILES = {
+    "debug": ["/Zi"],
+    "release": ["/O2", "/DNDEBUG"],
+    "relwithdebinfo": ["/O2", "/Zi", "/DNDEBUG"],
+    "native": ["/O2", "/DNDEBUG"],
+    "pgo": ["/O2", "/DNDEBUG"],
+}
 
 BUILD_DIR = Path("build")
 OBJ_DIR = BUILD_DIR / "obj"
@@ -12,6 +33,14 @@ BIN_DIR = BUILD_DIR / "bin"
 TEST_DIR = BUILD_DIR / "tests"
 
 
+def set_profile(profile: str):
+    global BUILD_DIR, OBJ_DIR, BIN_DIR, TEST_DIR
+    BUILD_DIR = Path("build" if profile == "debug" else f"build-{profile}")
+    OBJ_DIR = BUILD_DIR / "obj"
+    BIN_DIR = BUILD_DIR / "bin"
+    TEST_DIR = BUILD_DIR / "tests"
+
+
 def find_compilers():
     system_compilers = []
     if os.name == "nt":
@@ -29,92 +58,183 @@ def ensure_dirs():
         d.mkdir(parents=True, exist_ok=True)
 
 
+_print_lock = threading.Lock()
+
+# Worker count and optional compiler launcher (e.g. ccache), set from the
+# command line or the JOBS / COMPILER_LAUNCHER environment variables.
+JOBS = os.cpu_count() or 1
+LAUNCHER: List[str] = []
+
+
 def run(cmd: List[str], env=None) -> int:
-    print(">>>", " ".join(cmd))
     proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True, env=env)
-    sys.stdout.write(proc.stdout)
+    # Print the command and its output together so parallel jobs don't interleave.
+    with _print_lock:
+        print(">>>", " ".join(cmd))
+        sys.stdout.write(proc.stdout)
+        sys.stdout.flush()
     return proc.returncode
 
 
-def build_with_msvc():
+def parse_depfile(path: Path) -> List[Path]:
+    # Make-style rule written by -MMD: "obj: src hdr1 hdr2 \\\n hdr3 ...".
+    text = path.read_text().replace("\\\n", " ").replace("\\ ", "\0")
+    _, _, deps = text.partition(": ")
+    return [Path(d.replace("\0", " ")) for d in deps.split()]
+
+
+def command_stamp(cmd: Sequence[str]) -> str:
+    return hashlib.sha1("\0".join(cmd).encode()).hexdigest()
+
+
+def needs_compile(obj: Path, cmd: Sequence[str], deps: Optional[List[Path]]) -> bool:
+    # An object is stale if it is missing, was built with a different command
+    # line, or is older than its source or any header it included last time.
+    stamp = obj.with_suffix(obj.suffix + ".cmd")
+    if not obj.exists() or not stamp.exists() or stamp.read_text() != command_stamp(cmd):
+        return True
+    if deps is None:
+        return True
+    obj_mtime = obj.stat().st_mtime_ns
+    for dep in deps:
+        try:
+            if dep.stat().st_mtime_ns > obj_mtime:
+                return True
+        except FileNotFoundError:
+            return True
+    return False
+
+
+def compile_all(jobs: List[tuple]) -> int:
+    """jobs: (obj, cmd, deps_fn) where deps_fn returns the dependency list of
+    the last successful compile, or None if unknown. Stale objects are rebuilt
+    on a thread pool (each compile is its own process)."""
+    stale = [(obj, cmd) for obj, cmd, deps_fn in jobs if needs_compile(obj, cmd, deps_fn())]
+
+    def compile_one(item) -> int:
+        obj, cmd = item
+        rc = run([*LAUNCHER, *cmd])
+        if rc == 0:
+            obj.with_suffix(obj.suffix + ".cmd").write_text(command_stamp(cmd))
+        return rc
+
+    if not stale:
+        return 0
+    with ThreadPoolExecutor(max_workers=max(1, min(JOBS, len(stale)))) as pool:
+        results = list(pool.map(compile_one, stale))
+    return next((rc for rc in results if rc != 0), 0)
+
+
+def link_if_stale(out: Path, objs: Sequence[str], cmd: List[str]) -> int:
+    stamp = out.with_name(out.name + ".cmd")
+    if out.exists() and stamp.exists() and stamp.read_text() == command_stamp(cmd):
+        out_mtime = out.stat().st_mtime_ns
+        if all(Path(o).stat().st_mtime_ns <= out_mtime for o in objs):
+            return 0
+    rc = run(cmd)
+    if rc == 0:
+        stamp.write_text(command_stamp(cmd))
+    return rc
+
+
+def header_deps() -> List[Path]:
+    # Conservative dependency set for compilers without -MMD support.
+    return [p for d in ("include", "src", "third_party/minigtest") for p in Path(d).glob("*.h*")]
+
+
+def collect_sources():
+    lib = sorted(p for p in Path("src").glob("*.c") if p.name != "main.c")
+    lib += sorted(Path("src").glob("*.cpp"))
+    tests = sorted(Path("tests").glob("*.cpp")) + sorted(Path("third_party/minigtest").glob("*.cpp"))
+    return lib, tests, Path("src/main.c")
+
+
+def cxx_for(cc: str) -> str:
+    # gcc/clang only link libstdc++ when invoked through their C++ driver.
+    mapping = {"gcc": "g++", "clang": "clang++", "cc": "c++"}
+    cxx = mapping.get(cc, cc)
+    return cxx if shutil.which(cxx) else cc
+
+
+def build_with_msvc(profile: str):
     ensure_dirs()
-    cflags = ["/nologo", "/MD", "/Iinclude"]
+    cflags = ["/nologo", "/MD", "/Iinclude", *MSVC_PROFILES[profile]]
     cppflags = cflags + ["/std:c++17", "/EHsc", "/Ithird_party/minigtest"]
-    objs = [
-        (Path("src/calculator.c"), OBJ_DIR / "calculator.obj"),
-        (Path("third_party/minigtest/gtest.cpp"), OBJ_DIR / "gtest.obj"),
-        (Path("tests/test_calculator.cpp"), OBJ_DIR / "test_calculator.obj"),
-        (Path("src/main.c"), OBJ_DIR / "main.obj"),
-    ]
-    for src, obj in objs:
-        if src.suffix == ".c":
-            rc = run(["cl", *cflags, "/c", str(src), "/Fo" + str(obj)])
-        else:
-            rc = run(["cl", *cppflags, "/c", str(src), "/Fo" + str(obj)])
-        if rc != 0:
-            return rc
+    lib_srcs, test_srcs, main_src = collect_sources()
+    obj_of = {src: OBJ_DIR / (src.stem + ".obj") for src in [*lib_srcs, *test_srcs, main_src]}
+    headers = header_deps()
+    jobs = []
+    for src, obj in obj_of.items():
+        flags = cflags if src.suffix == ".c" else cppflags
+        jobs.append((obj, ["cl", *flags, "/c", str(src), "/Fo" + str(obj)], lambda src=src: [src, *headers]))
+    rc = compile_all(jobs)
+    if rc != 0:
+        return rc
     app = BIN_DIR / "demo_app.exe"
     tests_bin = TEST_DIR / "demo_tests.exe"
-    rc = run(["link", "/nologo", str(OBJ_DIR / "calculator.obj"), str(OBJ_DIR / "main.obj"), "/OUT:" + str(app)])
+    lib_objs = [str(obj_of[src]) for src in lib_srcs]
+    app_objs = [*lib_objs, str(obj_of[main_src])]
+    rc = link_if_stale(app, app_objs, ["link", "/nologo", *app_objs, "/OUT:" + str(app)])
     if rc != 0:
         return rc
-    rc = run(
-        [
-            "link",
-            "/nologo",
-            str(OBJ_DIR / "calculator.obj"),
-            str(OBJ_DIR / "gtest.obj"),
-            str(OBJ_DIR / "test_calculator.obj"),
-            "/OUT:" + str(tests_bin),
-        ]
-    )
-    return rc
+    test_objs = [*lib_objs, *[str(obj_of[src]) for src in test_srcs]]
+    return link_if_stale(tests_bin, test_objs, ["link", "/nologo", *test_objs, "/OUT:" + str(tests_bin)])
 
 
-def build_with_gcc_like(cc: str):
+def build_with_gcc_like(cc: str, profile: str, extra_flags: List[str] = ()):
     ensure_dirs()
-    cflags = ["-Wall", "-Wextra", "-g", "-Iinclude"]
+    cxx = cxx_for(cc)
+    cflags = ["-Wall", "-Wextra", "-Iinclude", *PROFILES[profile], *extra_flags]
     cppflags = cflags + ["-std=c++17", "-Ithird_party/minigtest"]
-    objs = [
-        (Path("src/calculator.c"), OBJ_DIR / "calculator.o"),
-        (Path("third_party/minigtest/gtest.cpp"), OBJ_DIR / "gtest.o"),
-        (Path("tests/test_calculator.cpp"), OBJ_DIR / "test_calculator.o"),
-        (Path("src/main.c"), OBJ_DIR / "main.o"),
-    ]
-    for src, obj in objs:
-        if src.suffix == ".c":
-            rc = run([cc, *cflags, "-c", str(src), "-o", str(obj)])
-        else:
-            rc = run([cc, *cppflags, "-c", str(src), "-o", str(obj)])
-        if rc != 0:
-            return rc
+    lib_srcs, test_srcs, main_src = collect_sources()
+    obj_of = {src: OBJ_DIR / (src.stem + ".o") for src in [*lib_srcs, *test_srcs, main_src]}
+    jobs = []
+    for src, obj in obj_of.items():
+        compiler, flags = (cc, cflags) if src.suffix == ".c" else (cxx, cppflags)
+        depfile = obj.with_suffix(".d")
+        cmd = [compiler, *flags, "-MMD", "-MF", str(depfile), "-c", str(src), "-o", str(obj)]
+        jobs.append((obj, cmd, lambda depfile=depfile: parse_depfile(depfile) if depfile.exists() else None))
+    rc = compile_all(jobs)
+    if rc != 0:
+        return rc
     app = BIN_DIR / "demo_app"
     tests_bin = TEST_DIR / "demo_tests"
-    rc = run([cc, *cflags, str(OBJ_DIR / "calculator.o"), str(OBJ_DIR / "main.o"), "-o", str(app)])
+    lib_objs = [str(obj_of[src]) for src in lib_srcs]
+    ldflags = ["-pthread", *[f for f in extra_flags if f.startswith("-fprofile-")]]
+    app_objs = [*lib_objs, str(obj_of[main_src])]
+    rc = link_if_stale(app, app_objs, [cxx, *cflags, *app_objs, "-o", str(app), *ldflags])
     if rc != 0:
         return rc
-    rc = run(
-        [
-            cc,
-            *cppflags,
-            str(OBJ_DIR / "calculator.o"),
-            str(OBJ_DIR / "gtest.o"),
-            str(OBJ_DIR / "test_calculator.o"),
-            "-o",
-            str(tests_bin),
-        ]
-    )
-    return rc
+    test_objs = [*lib_objs, *[str(obj_of[src]) for src in test_srcs]]
+    return link_if_stale(tests_bin, test_objs, [cxx, *cppflags, *test_objs, "-o", str(tests_bin), *ldflags])
+
 
+def build_pgo(cc: str):
+    # Instrumented build, a training run of the tests, then a rebuild in the
+    # same object directory so gcc finds each .gcda next to its object.
+    rc = build_with_gcc_like(cc, "pgo", ["-fprofile-generate", "-fprofile-update=atomic"])
+    if rc != 0:
+        return rc
+    env = os.environ.copy()
+    env["TEST_SHOULD_FAIL"] = "0"
+    proc = subprocess.run([str(TEST_DIR / "demo_tests")], stdout=subprocess.DEVNULL, env=env)
+    if proc.returncode != 0:
+        return proc.returncode
+    for obj in OBJ_DIR.glob("*.o"):
+        obj.unlink()
+    return build_with_gcc_like(cc, "pgo", ["-fprofile-use", "-fprofile-correction", "-Wno-missing-profile"])
 
-def build():
+
+def build(profile: str = "debug"):
     compiler = find_compilers()
     if not compiler:
         print("未找到可用编译器（cl/gcc/clang）。")
         return 1
     if compiler == "cl":
-        return build_with_msvc()
-    return build_with_gcc_like(compiler)
+        return build_with_msvc(profile)
+    if profile == "pgo":
+        return build_pgo(compiler)
+    return build_with_gcc_like(compiler, profile)
 
 
 def run_tests():
@@ -131,13 +251,24 @@ def run_tests():
 
 
 def main():
+    global JOBS, LAUNCHER
     parser = argparse.ArgumentParser(description="Python fallback builder for demo_c_project")
     parser.add_argument("action", choices=["build", "test", "clean"], help="构建或测试")
+    parser.add_argument("--profile", choices=sorted(PROFILES), default="debug", help="构建配置")
+    parser.add_argument("-j", "--jobs", type=int, default=int(os.environ.get("JOBS", JOBS)), help="并行编译数")
+    parser.add_argument(
+        "--launcher",
+        default=os.environ.get("COMPILER_LAUNCHER", ""),
+        help="编译器前缀命令，例如 ccache",
+    )
     args = parser.parse_args()
+    set_profile(args.profile)
+    JOBS = max(1, args.jobs)
+    LAUNCHER = shlex.split(args.launcher)
     if args.action == "build":
-        sys.exit(build())
+        sys.exit(build(args.profile))
     if args.action == "test":
-        rc = build()
+        rc = build(args.profile)
         if rc != 0:
             sys.exit(rc)
         sys.exit(run_tests())
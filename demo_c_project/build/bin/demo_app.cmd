@@ -0,0 +1 @@
+d824f617fbeffcc52c37eb032214d04c743a23c6
\ No newline at end of file
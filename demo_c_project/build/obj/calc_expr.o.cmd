@@ -0,0 +1 @@
+5e34f0cab59b8fcbe1b1db9da37bd1e59a1ffda3
\ No newline at end of file
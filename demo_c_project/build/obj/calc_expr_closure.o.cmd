@@ -0,0 +1 @@
+63ce7226b2e94721975017ec0d52c0c0f2dbff68
\ No newline at end of file
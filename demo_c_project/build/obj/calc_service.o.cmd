@@ -0,0 +1 @@
+4d21a614ed3940e7a6d930622683391b1b7a2a4b
\ No newline at end of file
@@ -0,0 +1 @@
+47b31008e5a1976f881abe58e4c401760fdaea69
\ No newline at end of file
@@ -0,0 +1 @@
+63c065d75d4b8adea4146e94d6344a333a4c6215
\ No newline at end of file
@@ -0,0 +1 @@
+9b423d0f665d863d39c99b18d245e91a04cf7089
\ No newline at end of file
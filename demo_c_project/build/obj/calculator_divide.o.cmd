@@ -0,0 +1 @@
+52e8801e2402bd22b1fee880a9c4e8678fc162e0
\ No newline at end of file
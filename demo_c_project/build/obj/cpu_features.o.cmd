@@ -0,0 +1 @@
+56f3cf372e2d1efa0c97d65c8438cb68912a9ce4
\ No newline at end of file
@@ -0,0 +1 @@
+f4639f437a4d90fad663c42e8168570e4e35464b
\ No newline at end of file
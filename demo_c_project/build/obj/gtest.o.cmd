@@ -0,0 +1 @@
+afddb20d47d7e529d89e76cd33df6b64874dc1d3
\ No newline at end of file
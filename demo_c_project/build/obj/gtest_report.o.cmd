@@ -0,0 +1 @@
+ba3cf5ef0d404d5e7a74197bd1f518ecb30d2819
\ No newline at end of file
@@ -0,0 +1 @@
+03d79903175822c24aad3bd4135c9e01b9f10479
\ No newline at end of file
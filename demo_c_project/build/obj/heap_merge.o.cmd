@@ -0,0 +1 @@
+162cdd7a373cde8226ebaaa53b70b3b4630e6484
\ No newline at end of file
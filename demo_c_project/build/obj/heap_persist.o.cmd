@@ -0,0 +1 @@
+e58944eef0f134be96bfc0e84eb383962ca774d5
\ No newline at end of file
@@ -0,0 +1 @@
+2c209b9e4fc6a49b1b5cfa4412e82aefe1debae7
\ No newline at end of file
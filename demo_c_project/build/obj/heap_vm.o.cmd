@@ -0,0 +1 @@
+f71a56a829d410acf10d44bd8472d3c8a6ba2182
\ No newline at end of file
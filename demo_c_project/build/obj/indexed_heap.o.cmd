@@ -0,0 +1 @@
+ad244bb5ad1e928966f10d5c2b29dea0968aca08
\ No newline at end of file
@@ -0,0 +1 @@
+560c6e6c5d939f523286a256d17fbe1d2638455f
\ No newline at end of file
@@ -0,0 +1 @@
+77b60321387d6a42e8a5c022bcb067a16fc110c0
\ No newline at end of file
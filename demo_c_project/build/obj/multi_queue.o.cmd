@@ -0,0 +1 @@
+fbd871957da67d888e74329ae0b5ac32f15ce26c
\ No newline at end of file
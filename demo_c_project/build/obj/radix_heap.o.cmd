@@ -0,0 +1 @@
+5230bca26518a18391e723bb99fdecc976469b62
\ No newline at end of file
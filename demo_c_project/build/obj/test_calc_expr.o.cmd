@@ -0,0 +1 @@
+3b6b28cd90005e4fbd2153a93e7567ea7d2399de
\ No newline at end of file
@@ -0,0 +1 @@
+c70341b77c152b67e96e43069e5abb6756211754
\ No newline at end of file
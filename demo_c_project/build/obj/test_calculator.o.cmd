@@ -0,0 +1 @@
+3918bca225b3fb6ad6796cc4c2ce1d8c3be0a27f
\ No newline at end of file
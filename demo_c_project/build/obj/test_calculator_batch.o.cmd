@@ -0,0 +1 @@
+554ada2576ddc562ea67ae355b3c3aaae77c829b
\ No newline at end of file
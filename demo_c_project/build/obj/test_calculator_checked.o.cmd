@@ -0,0 +1 @@
+4bc5a97f73a1700eda6aada3b8a064ca10d8e37b
\ No newline at end of file
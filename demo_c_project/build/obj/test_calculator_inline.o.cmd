@@ -0,0 +1 @@
+81d04a813f495d7674f2c967f3373bf74e7cf4a1
\ No newline at end of file
@@ -0,0 +1 @@
+bef333f4ac6a63e672dc0824343230779a50c871
\ No newline at end of file
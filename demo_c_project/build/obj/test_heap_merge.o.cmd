@@ -0,0 +1 @@
+3213597e8ff9d1d91c9de46b255e9a2c63960006
\ No newline at end of file
@@ -0,0 +1 @@
+5f8f3c7c7f3e92dd87e417105a224f76201defc1
\ No newline at end of file
@@ -0,0 +1 @@
+9aaf23db9a51930feafa977ee85cc74dfb156c75
\ No newline at end of file
@@ -0,0 +1 @@
+ef0fa52fbceac9cdd361d709365b7ea819559146
\ No newline at end of file
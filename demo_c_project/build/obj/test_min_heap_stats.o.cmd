@@ -0,0 +1 @@
+e960fffe53ade67ba95c41c10bbe1e7443f52cd5
\ No newline at end of file
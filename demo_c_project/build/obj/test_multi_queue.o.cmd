@@ -0,0 +1 @@
+d0bacea4061c846d50f8f28d7757dd40dc9c2741
\ No newline at end of file
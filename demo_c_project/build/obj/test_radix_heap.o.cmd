@@ -0,0 +1 @@
+21f4164e47dcae35196646dec8983cbd6309d6d8
\ No newline at end of file
@@ -0,0 +1 @@
+858c058685d7449539472480b8db98f26656c70a
\ No newline at end of file
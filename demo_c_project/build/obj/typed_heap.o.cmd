@@ -0,0 +1 @@
+a3f6abaf4cb6ae951b80d5628e40c86764a6340e
\ No newline at end of file
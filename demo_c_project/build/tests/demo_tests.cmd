@@ -0,0 +1 @@
+ab924fc9991ee652f08179158475ff5bc31a74af
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Integer expression engine over the calculator primitives.
+ *
+ * Sources use decimal literals, identifiers, + - * / %, unary minus and
+ * parentheses, e.g. "(a*b + c) % m"; -2147483648 is accepted as INT_MIN, and
+ * more than 256 nested parentheses or unary signs is a syntax error; that is
+ * the only size limit besides memory. An
+ * expression is parsed once into bytecode with constant sub-expressions
+ * folded, then evaluated either per row or over whole columns with the array
+ * kernels from calculator.h.
+ *
+ * Semantics match the array kernels: + - * wrap on overflow, / and % by zero
+ * yield 0 and raise the error flag (like divide/calculator_mod), and
+ * INT_MIN / -1 wraps to INT_MIN. Variables are numbered in order of first
+ * appearance; `vars` and `columns` are indexed by that number. */
+typedef struct calc_expr calc_expr_t;
+
+/* Returns NULL on a syntax error and writes a message to `error` (if given). */
+calc_expr_t* calc_expr_compile(const char* source, char* error, size_t error_size);
+void calc_expr_destroy(calc_expr_t* expr);
+
+int calc_expr_var_count(const calc_expr_t* expr);
+const char* calc_expr_var_name(const calc_expr_t* expr, int index);
+/* Returns -1 if the expression does not reference `name`. */
+int calc_expr_var_index(const calc_expr_t* expr, const char* name);
+/* Number of bytecode instructions after folding; 1 for a constant. */
+int calc_expr_code_size(const calc_expr_t* expr);
+
+int calc_expr_eval(const calc_expr_t* expr, const int* vars, int* error);
+/* Evaluates n rows; columns[v][i] is variable v in row i. Sets bit i of
+ * error_bits ((n + 7) / 8 bytes, may be NULL) for rows that divided by zero
+ * and returns 1 if any row did, or -1 if scratch allocation failed. */
+int calc_expr_eval_n(const calc_expr_t* expr, const int* const* columns, int* out, unsigned char* error_bits,
+                     size_t n);
+
+/* Runtime specialisation for formulas loaded from config: the bytecode is
+ * compiled once into a tree of operator functions specialised on their operand
+ * kinds (closure compilation; no machine code is generated). Results and error
+ * flags are identical to calc_expr_eval/calc_expr_eval_n. The closure does not
+ * reference `expr` after compilation. */
+typedef struct calc_expr_closure calc_expr_closure_t;
+
+calc_expr_closure_t* calc_expr_closure_compile(const calc_expr_t* expr);
+void calc_expr_closure_destroy(calc_expr_closure_t* closure);
+int calc_expr_closure_eval(const calc_expr_closure_t* closure, const int* vars, int* error);
+int calc_expr_closure_eval_n(const calc_expr_closure_t* closure, const int* const* columns, int* out,
+                             unsigned char* error_bits, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
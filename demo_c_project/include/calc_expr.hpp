@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "calc_expr_ops.h"
+
+// Compile-time specialised expressions. The formula is spelled in C++ and
+// becomes a tree of types, so each operator inlines into the caller's loop and
+// constant divisors written as calc::constant<N> let the compiler strength-
+// reduce / and %. Results and error flags match calc_expr_eval:
+//
+//   using namespace calc;
+//   auto rule = (var<0>() * var<1>() + var<2>()) % var<3>();
+//   int v = rule.eval(row, &err);
+//   rule.eval_n(columns, out, error_bits, n);
+namespace calc {
+
+template <typename Derived>
+struct expr_base {
+    int eval(const int* row, int* error) const {
+        int err = 0;
+        int v = self().at(row, 0, err);
+        if (error) *error = err;
+        return v;
+    }
+
+    // Same contract as calc_expr_eval_n; returns 1 if any row divided by zero.
+    int eval_n(const int* const* columns, int* out, unsigned char* error_bits, std::size_t n) const {
+        int any = 0;
+        if (error_bits) std::memset(error_bits, 0, (n + 7) / 8);
+        for (std::size_t i = 0; i < n; ++i) {
+            int err = 0;
+            out[i] = self().column_at(columns, i, err);
+            any |= err;
+            if (error_bits) error_bits[i / 8] |= static_cast<unsigned char>(err << (i % 8));
+        }
+        return any;
+    }
+
+private:
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
+
+template <int Index>
+struct var : expr_base<var<Index>> {
+    int at(const int* row, std::size_t, int&) const { return row[Index]; }
+    int column_at(const int* const* columns, std::size_t i, int&) const { return columns[Index][i]; }
+};
+
+struct literal : expr_base<literal> {
+    explicit literal(int v) : value(v) {}
+    int at(const int*, std::size_t, int&) const { return value; }
+    int column_at(const int* const*, std::size_t, int&) const { return value; }
+    int value;
+};
+
+template <int Value>
+struct constant : expr_base<constant<Value>> {
+    int at(const int*, std::size_t, int&) const { return Value; }
+    int column_at(const int* const*, std::size_t, int&) const { return Value; }
+};
+
+template <int Op, typename L, typename R>
+struct binary : expr_base<binary<Op, L, R>> {
+    binary(const L& l, const R& r) : lhs(l), rhs(r) {}
+    int at(const int* row, std::size_t i, int& err) const {
+        return calc_expr_apply(Op, lhs.at(row, i, err), rhs.at(row, i, err), &err);
+    }
+    int column_at(const int* const* columns, std::size_t i, int& err) const {
+        return calc_expr_apply(Op, lhs.column_at(columns, i, err), rhs.column_at(columns, i, err), &err);
+    }
+    L lhs;
+    R rhs;
+};
+
+template <typename E>
+struct negate : expr_base<negate<E>> {
+    explicit negate(const E& e) : operand(e) {}
+    int at(const int* row, std::size_t i, int& err) const {
+        return static_cast<int>(0u - static_cast<unsigned>(operand.at(row, i, err)));
+    }
+    int column_at(const int* const* columns, std::size_t i, int& err) const {
+        return static_cast<int>(0u - static_cast<unsigned>(operand.column_at(columns, i, err)));
+    }
+    E operand;
+};
+
+namespace detail {
+template <typename T>
+using is_expr = std::is_base_of<expr_base<T>, T>;
+
+template <typename T>
+struct as_expr {
+    using type = T;
+    static const T& wrap(const T& e) { return e; }
+};
+
+template <>
+struct as_expr<int> {
+    using type = literal;
+    static literal wrap(int v) { return literal(v); }
+};
+
+template <typename L, typename R>
+using enable_binary = std::enable_if_t<(is_expr<L>::value || is_expr<R>::value) &&
+                                       (is_expr<L>::value || std::is_same<L, int>::value) &&
+                                       (is_expr<R>::value || std::is_same<R, int>::value)>;
+
+template <int Op, typename L, typename R>
+binary<Op, typename as_expr<L>::type, typename as_expr<R>::type> make(const L& l, const R& r) {
+    return {as_expr<L>::wrap(l), as_expr<R>::wrap(r)};
+}
+}  // namespace detail
+
+template <typename L, typename R, typename = detail::enable_binary<L, R>>
+auto operator+(const L& l, const R& r) { return detail::make<CALC_EXPR_OP_ADD>(l, r); }
+template <typename L, typename R, typename = detail::enable_binary<L, R>>
+auto operator-(const L& l, const R& r) { return detail::make<CALC_EXPR_OP_SUB>(l, r); }
+template <typename L, typename R, typename = detail::enable_binary<L, R>>
+auto operator*(const L& l, const R& r) { return detail::make<CALC_EXPR_OP_MUL>(l, r); }
+template <typename L, typename R, typename = detail::enable_binary<L, R>>
+auto operator/(const L& l, const R& r) { return detail::make<CALC_EXPR_OP_DIV>(l, r); }
+template <typename L, typename R, typename = detail::enable_binary<L, R>>
+auto operator%(const L& l, const R& r) { return detail::make<CALC_EXPR_OP_MOD>(l, r); }
+
+template <typename E, typename = std::enable_if_t<detail::is_expr<E>::value>>
+negate<E> operator-(const E& e) { return negate<E>(e); }
+
+}  // namespace calc
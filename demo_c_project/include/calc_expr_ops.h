@@ -0,0 +1,49 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Operator codes and scalar semantics shared by every expression evaluator
+ * (bytecode interpreter, column evaluator, closures and the C++ templates in
+ * calc_expr.hpp), so all of them agree bit for bit. Public only because the
+ * header-only templates need it; not part of the calc_expr.h API. */
+enum {
+    CALC_EXPR_OP_CONST,
+    CALC_EXPR_OP_VAR,
+    CALC_EXPR_OP_NEG,
+    CALC_EXPR_OP_ADD,
+    CALC_EXPR_OP_SUB,
+    CALC_EXPR_OP_MUL,
+    CALC_EXPR_OP_DIV,
+    CALC_EXPR_OP_MOD,
+};
+
+/* One operator; + - * wrap, / and % by zero return 0 and set *error, and
+ * INT_MIN / -1 wraps to INT_MIN. */
+static inline int calc_expr_apply(int op, int a, int b, int* error) {
+    switch (op) {
+    case CALC_EXPR_OP_ADD:
+        return (int)((unsigned)a + (unsigned)b);
+    case CALC_EXPR_OP_SUB:
+        return (int)((unsigned)a - (unsigned)b);
+    case CALC_EXPR_OP_MUL:
+        return (int)((unsigned)a * (unsigned)b);
+    case CALC_EXPR_OP_DIV:
+    case CALC_EXPR_OP_MOD:
+        if (b == 0) {
+            *error = 1;
+            return 0;
+        }
+        if (b == -1) {
+            return op == CALC_EXPR_OP_DIV ? (int)(0u - (unsigned)a) : 0;
+        }
+        return op == CALC_EXPR_OP_DIV ? a / b : a % b;
+    default:
+        return 0;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
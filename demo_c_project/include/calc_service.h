@@ -0,0 +1,68 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Asynchronous calculator service: callers queue requests on a submission
+ * ring and collect results from a completion ring, while a pool of worker
+ * threads drains the rings in batches through the array kernels of
+ * calculator.h (add_n, divide_n, ...).
+ *
+ * Each client owns one SPSC submission ring and one SPSC completion ring and
+ * is served by exactly one worker (assigned round-robin), so no ring needs a
+ * lock or CAS. A client must only be used from one thread at a time;
+ * use one client per submitting thread. Results and the divide-by-zero error
+ * flag match the array kernels, i.e. the scalar functions, except that
+ * INT_MIN / -1 wraps instead of trapping.
+ * Completions for one client arrive in submission order. */
+enum calc_svc_op {
+    CALC_SVC_OP_ADD,
+    CALC_SVC_OP_SUBTRACT,
+    CALC_SVC_OP_MULTIPLY,
+    CALC_SVC_OP_DIVIDE,
+    CALC_SVC_OP_MOD
+};
+
+typedef struct calc_sqe {
+    int op;
+    int a;
+    int b;
+    unsigned long long user_data;
+} calc_sqe_t;
+
+typedef struct calc_cqe {
+    unsigned long long user_data;
+    int result;
+    int error;
+} calc_cqe_t;
+
+typedef struct calc_service calc_service_t;
+typedef struct calc_client calc_client_t;
+
+/* workers <= 0 selects one per hardware thread; with pin != 0 worker i is
+ * bound to CPU i where the platform supports it. Returns NULL on failure. */
+calc_service_t* calc_service_create(int workers, int pin);
+/* Stops the workers; destroy every client first. */
+void calc_service_destroy(calc_service_t* service);
+
+/* ring_entries is rounded up to a power of two; the completion ring has the
+ * same size, and a worker never takes more requests than it has completion
+ * slots for, so an unreaped client stalls only itself. */
+calc_client_t* calc_client_create(calc_service_t* service, int ring_entries);
+/* Waits for the client's worker to let go of it; pending work is dropped. */
+void calc_client_destroy(calc_client_t* client);
+
+/* Queues up to n requests and returns how many fit (0 when the ring is
+ * full). Requests with an unknown op complete with error = -1. */
+int calc_client_submit(calc_client_t* client, const calc_sqe_t* sqes, int n);
+/* Copies up to max completions without blocking and returns the count. */
+int calc_client_reap(calc_client_t* client, calc_cqe_t* out, int max);
+/* Like reap, but first waits until at least min(min_complete, max)
+ * completions are available; waiting for more than are outstanding never
+ * returns. */
+int calc_client_wait(calc_client_t* client, calc_cqe_t* out, int max, int min_complete);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,17 +1,182 @@
 #pragma once
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Define CALCULATOR_INLINE before including this header to get inline
+ * definitions of the scalar primitives instead of calls into calculator.c. */
+#ifdef CALCULATOR_INLINE
+#include "calculator_inline.h"
+#else
 int add(int a, int b);
 int subtract(int a, int b);
 int multiply(int a, int b);
 int calculator_mod(int a, int b, int* error);
 int divide(int a, int b, int* error);
+#endif
+
+/* Element-wise array forms of add/subtract/multiply. Results wrap on overflow.
+ * out may be the same array as a or b; the _inplace_n forms write into a and
+ * the _scalar_n forms broadcast b. SIMD paths (AVX2, AVX-512, NEON) are chosen
+ * at runtime via cpu_features(). */
+void add_n(const int* a, const int* b, int* out, size_t n);
+void subtract_n(const int* a, const int* b, int* out, size_t n);
+void multiply_n(const int* a, const int* b, int* out, size_t n);
+void add_inplace_n(int* a, const int* b, size_t n);
+void subtract_inplace_n(int* a, const int* b, size_t n);
+void multiply_inplace_n(int* a, const int* b, size_t n);
+void add_scalar_n(const int* a, int b, int* out, size_t n);
+void subtract_scalar_n(const int* a, int b, int* out, size_t n);
+void multiply_scalar_n(const int* a, int b, int* out, size_t n);
+
+/* A divisor prepared once for repeated division by multiply-high and shift
+ * instead of idiv. prepare returns 1 (and the kernels fill zeros) when the
+ * divisor is 0. Batch kernels report divide-by-zero once through their return
+ * value; divide_n/mod_n take per-element divisors and optionally set bit i of
+ * error_bits ((n + 7) / 8 bytes) for element i. out may be the same array as
+ * a or b. Quotients truncate toward zero like `/`; INT_MIN / -1 wraps to
+ * INT_MIN with remainder 0. */
+typedef struct calc_divisor {
+    int divisor;
+    int kind;
+    int magic;
+    int shift;
+    int correction;
+} calc_divisor_t;
+
+int calc_divisor_prepare(calc_divisor_t* d, int divisor);
+int calc_divisor_divide(const calc_divisor_t* d, int n);
+int divide_prepared_n(const int* a, const calc_divisor_t* d, int* out, size_t n);
+int mod_prepared_n(const int* a, const calc_divisor_t* d, int* out, size_t n);
+int divide_scalar_n(const int* a, int b, int* out, size_t n);
+int mod_scalar_n(const int* a, int b, int* out, size_t n);
+int divide_n(const int* a, const int* b, int* out, unsigned char* error_bits, size_t n);
+int mod_n(const int* a, const int* b, int* out, unsigned char* error_bits, size_t n);
+
+/* Overflow-aware arithmetic. _checked forms return the wrapped result and set
+ * *overflow (may be NULL); _sat forms clamp to INT_MIN/INT_MAX. INT_MIN / -1
+ * counts as overflow (saturating to INT_MAX); divide-by-zero still goes
+ * through `error` like divide(). The array forms return 1 if any element
+ * overflowed (or saturated) and 0 otherwise, so a single flag per batch
+ * replaces a separate validation pass. The division array forms share
+ * divide_n/mod_n's loop: INT_MIN / -1 counts as overflow (wrapping to INT_MIN,
+ * or INT_MAX for divide_sat_n; remainder 0) and divide-by-zero is reported
+ * through error_bits, plus *error (may be NULL) for the whole batch. There is
+ * no mod_sat_n: a remainder never exceeds the int range, so mod_checked_n
+ * already returns the exact result. */
+int add_checked(int a, int b, int* overflow);
+int subtract_checked(int a, int b, int* overflow);
+int multiply_checked(int a, int b, int* overflow);
+int divide_checked(int a, int b, int* error, int* overflow);
+int add_sat(int a, int b);
+int subtract_sat(int a, int b);
+int multiply_sat(int a, int b);
+int divide_sat(int a, int b, int* error);
+int add_checked_n(const int* a, const int* b, int* out, size_t n);
+int subtract_checked_n(const int* a, const int* b, int* out, size_t n);
+int multiply_checked_n(const int* a, const int* b, int* out, size_t n);
+int divide_checked_n(const int* a, const int* b, int* out, unsigned char* error_bits, int* error, size_t n);
+int mod_checked_n(const int* a, const int* b, int* out, unsigned char* error_bits, int* error, size_t n);
+int add_sat_n(const int* a, const int* b, int* out, size_t n);
+int subtract_sat_n(const int* a, const int* b, int* out, size_t n);
+int multiply_sat_n(const int* a, const int* b, int* out, size_t n);
+int divide_sat_n(const int* a, const int* b, int* out, unsigned char* error_bits, int* error, size_t n);
+
+/* Storage hooks for min_heap_t. `resize` receives the old size so arena-style
+ * allocators can grow in place; ctx is passed through untouched. */
+typedef struct min_heap_allocator {
+    void* (*alloc)(void* ctx, size_t bytes);
+    void* (*resize)(void* ctx, void* ptr, size_t old_bytes, size_t new_bytes);
+    void (*release)(void* ctx, void* ptr, size_t bytes);
+    void* ctx;
+} min_heap_allocator_t;
+
+/* Treat the fields as read-only; a NULL allocator means malloc/realloc/free.
+ * Functions returning int report 0 on success and -1 on allocation failure or
+ * an empty heap, except min_heap_pop_n which returns the number of values
+ * written to `out`. */
+typedef struct min_heap {
+    int* data;
+    int size;
+    int capacity;
+    const min_heap_allocator_t* allocator;
+} min_heap_t;
+
+int min_heap_init(min_heap_t* heap, int capacity_hint, const min_heap_allocator_t* allocator);
+int min_heap_reserve(min_heap_t* heap, int capacity);
+int min_heap_shrink_to_fit(min_heap_t* heap);
+int min_heap_push(min_heap_t* heap, int value);
+int min_heap_push_many(min_heap_t* heap, const int* values, int n);
+int min_heap_assign(min_heap_t* heap, const int* values, int n);
+int min_heap_pop(min_heap_t* heap, int* out);
+int min_heap_pop_n(min_heap_t* heap, int* out, int k);
+int min_heap_peek(const min_heap_t* heap, int* out);
+void min_heap_destroy(min_heap_t* heap);
+
+/* Snapshots for fast restart. save writes a header (magic, version, element
+ * size, byte order, count, payload checksum, header check) and the backing
+ * array in heap order, and replaces `path` atomically. load_mmap initialises
+ * *heap over a private copy-on-write mapping of the file, so no re-heapify or
+ * re-insert is needed and the file is never modified; growth moves the array
+ * to anonymous memory. A snapshot with a bad header or size (or from another
+ * byte order) is rejected with -1. The payload checksum is only verified with
+ * MIN_HEAP_LOAD_VERIFY, since hashing it touches every page of the mapping.
+ * Release the heap with min_heap_destroy as usual. */
+#define MIN_HEAP_LOAD_VERIFY 1u
+int min_heap_save(const min_heap_t* heap, const char* path);
+int min_heap_load_mmap(min_heap_t* heap, const char* path, unsigned flags);
+
+/* Backing store for very large heaps: reserves max_bytes of address space up
+ * front and commits pages as the heap grows, so resizes happen in place with
+ * no copy and the array address never changes. MIN_HEAP_VM_HUGETLB asks for
+ * explicit 2 MiB pages (falling back to THP when the pool is empty);
+ * MIN_HEAP_VM_THP only advises transparent huge pages. numa_node >= 0 binds
+ * the range to that node and fails with -1 where binding is unavailable.
+ * Pass &arena->allocator to min_heap_init; an arena backs one heap at a time,
+ * and pushes beyond max_bytes fail with -1. Destroy the heap first. */
+#define MIN_HEAP_VM_HUGETLB 1u
+#define MIN_HEAP_VM_THP 2u
+
+typedef struct min_heap_vm_arena {
+    min_heap_allocator_t allocator;
+    void* base;
+    size_t reserved;
+    size_t committed;
+    size_t page_size;
+    int huge_pages;
+    int in_use;
+} min_heap_vm_arena_t;
+
+int min_heap_vm_arena_init(min_heap_vm_arena_t* arena, size_t max_bytes, unsigned flags, int numa_node);
+void min_heap_vm_arena_destroy(min_heap_vm_arena_t* arena);
+
+/* Per-thread counters for the min_heap_* and legacy min_heap_insert paths,
+ * available when the library is built with MIN_HEAP_STATS (make STATS=1).
+ * Levels count the positions an element moved; reallocs count successful
+ * alloc/resize calls. get copies the calling thread's totals and
+ * returns 0, or zeroes *out and returns -1 in builds without the counters. */
+typedef struct min_heap_stats {
+    unsigned long long comparisons;
+    unsigned long long swaps;
+    unsigned long long sift_up_levels;
+    unsigned long long sift_down_levels;
+    unsigned long long reallocs;
+    unsigned long long pushes;
+} min_heap_stats_t;
+
+int min_heap_stats_enabled(void);
+int min_heap_stats_get(min_heap_stats_t* out);
+void min_heap_stats_reset(void);
 
 void min_heap_insert(int** heap, int* size, int* capacity, int value);
+void min_heap_build(int** heap, int* size, int* capacity, const int* values, int n);
+void min_heap_insert_many(int** heap, int* size, int* capacity, const int* values, int n);
 int min_heap_delete_min(int** heap, int* size);
+int min_heap_delete_min_n(int** heap, int* size, int* out, int k);
+void min_heap_sort(int* heap, int size);
 int min_heap_peek_min(int* heap, int size);
 void destroy_queue(int** heap, int* size, int* capacity);
 
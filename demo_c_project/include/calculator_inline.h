@@ -0,0 +1,44 @@
+#pragma once
+
+/* Definitions of the scalar calculator primitives. calculator.h includes this
+ * file when CALCULATOR_INLINE is defined, so callers get static inline copies
+ * that the compiler can fold into their loops without LTO. calculator.c
+ * includes it with CALCULATOR_API_INLINE defined empty to emit the regular
+ * out-of-line symbols, so both forms share one body. */
+#ifndef CALCULATOR_API_INLINE
+#define CALCULATOR_API_INLINE static inline
+#endif
+
+CALCULATOR_API_INLINE int add(int a, int b) {
+    return a + b;
+}
+
+CALCULATOR_API_INLINE int subtract(int a, int b) {
+    return a - b;
+}
+
+CALCULATOR_API_INLINE int multiply(int a, int b) {
+    return a * b;
+}
+
+CALCULATOR_API_INLINE int calculator_mod(int a, int b, int* error) {
+    if (b == 0) {
+        if (error) *error = 1;
+        return 0;
+    }
+    if (error) *error = 0;
+    return a % b;
+}
+
+CALCULATOR_API_INLINE int divide(int a, int b, int* error) {
+    if (b == 0) {
+        if (error) {
+            *error = 1;
+        }
+        return 0;
+    }
+    if (error) {
+        *error = 0;
+    }
+    return a / b;
+}
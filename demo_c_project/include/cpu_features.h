@@ -0,0 +1,23 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    CPU_FEATURE_SSE41 = 1u << 0,
+    CPU_FEATURE_AVX2 = 1u << 1,
+    CPU_FEATURE_AVX512F = 1u << 2,
+    CPU_FEATURE_NEON = 1u << 3,
+};
+
+/* Features detected on the running CPU, restricted by cpu_features_set_mask. */
+unsigned cpu_features(void);
+/* Restricts dispatch to the given features (e.g. 0 forces the scalar paths);
+ * pass ~0u to restore full detection. The mask applies to the calling thread
+ * only. Intended for tests and benchmarks. */
+void cpu_features_set_mask(unsigned mask);
+
+#ifdef __cplusplus
+}
+#endif
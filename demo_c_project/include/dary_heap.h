@@ -0,0 +1,25 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 4-ary and 8-ary min-heaps with the same contract as the min_heap_* functions
+ * in calculator.h: the buffer starts at NULL/0/0, grows from 10 by doubling,
+ * and delete_min/peek_min return -1 on an empty heap. Pops run the SIMD
+ * sift-down kernels from heap_kernels.h. */
+void dary4_heap_insert(int** heap, int* size, int* capacity, int value);
+int dary4_heap_delete_min(int** heap, int* size);
+int dary4_heap_delete_min_n(int** heap, int* size, int* out, int k);
+int dary4_heap_peek_min(int* heap, int size);
+void dary4_destroy_queue(int** heap, int* size, int* capacity);
+
+void dary8_heap_insert(int** heap, int* size, int* capacity, int value);
+int dary8_heap_delete_min(int** heap, int* size);
+int dary8_heap_delete_min_n(int** heap, int* size, int* out, int k);
+int dary8_heap_peek_min(int* heap, int size);
+void dary8_destroy_queue(int** heap, int* size, int* capacity);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// d-ary min-heap. The children of node i are stored contiguously at
+// D * i + 1 .. D * i + D, so with D = 4 or 8 ints a sift level scans one
+// contiguous child group and the tree is log2(D) times shallower than the
+// binary layout. Groups are not aligned to cache lines, so a level touches at
+// most two lines rather than exactly one. The static helpers operate on raw
+// arrays so that the C shim in dary_heap.h can reuse them on malloc-managed
+// buffers.
+template <typename T, unsigned D = 4, typename Compare = std::less<T>>
+class dary_heap {
+    static_assert(D >= 2, "dary_heap arity must be at least 2");
+
+public:
+    static constexpr unsigned arity = D;
+
+    explicit dary_heap(const Compare& cmp = Compare()) : cmp_(cmp) {}
+
+    bool empty() const { return data_.empty(); }
+    std::size_t size() const { return data_.size(); }
+    const T& top() const { return data_.front(); }
+    const T* data() const { return data_.data(); }
+
+    void reserve(std::size_t n) { data_.reserve(n); }
+    void clear() { data_.clear(); }
+
+    void push(const T& value) {
+        data_.push_back(value);
+        sift_up(data_.data(), data_.size() - 1, cmp_);
+    }
+
+    void pop() {
+        pop_root(data_.data(), data_.size(), cmp_);
+        data_.pop_back();
+    }
+
+    static std::size_t min_child(const T* data, std::size_t first, std::size_t count, const Compare& cmp) {
+        std::size_t best = first;
+        for (std::size_t c = first + 1; c < first + count; ++c) {
+            if (cmp(data[c], data[best])) best = c;
+        }
+        return best;
+    }
+
+    static void sift_up(T* data, std::size_t idx, const Compare& cmp) {
+        T value = std::move(data[idx]);
+        while (idx > 0) {
+            std::size_t parent = (idx - 1) / D;
+            if (!cmp(value, data[parent])) break;
+            data[idx] = std::move(data[parent]);
+            idx = parent;
+        }
+        data[idx] = std::move(value);
+    }
+
+    static void sift_down(T* data, std::size_t size, std::size_t idx, const Compare& cmp) {
+        T value = std::move(data[idx]);
+        while (true) {
+            std::size_t first = idx * D + 1;
+            if (first >= size) break;
+            std::size_t count = size - first < D ? size - first : D;
+            std::size_t best = min_child(data, first, count, cmp);
+            if (!cmp(data[best], value)) break;
+            data[idx] = std::move(data[best]);
+            idx = best;
+        }
+        data[idx] = std::move(value);
+    }
+
+    static void heapify(T* data, std::size_t size, const Compare& cmp) {
+        if (size < 2) return;
+        for (std::size_t idx = (size - 2) / D + 1; idx-- > 0;) {
+            sift_down(data, size, idx, cmp);
+        }
+    }
+
+    // Moves the root of a non-empty heap of `size` elements into
+    // data[size - 1] and restores the heap property on the first size - 1.
+    static void pop_root(T* data, std::size_t size, const Compare& cmp) {
+        if (size > 1) {
+            std::swap(data[0], data[size - 1]);
+            sift_down(data, size - 1, 0, cmp);
+        }
+    }
+
+private:
+    std::vector<T> data_;
+    Compare cmp_;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Sift-down kernels for int min-heaps of arity 4 and 8. When a node has a full
+ * set of children the minimum child is found with a SIMD horizontal min
+ * (SSE4.1/AVX2 on x86, NEON on AArch64), chosen at runtime via cpu_features();
+ * the scalar compare chain remains the fallback. */
+void heap_sift_down_d4(int* heap, int size, int idx);
+void heap_sift_down_d8(int* heap, int size, int idx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Sort-and-merge pipeline over the min_heap code. Chunks are heapified and
+ * drained with min_heap_sort on separate threads, then merged through a
+ * kv_heap_t of run heads. All functions return 0 on success and -1 on
+ * allocation or I/O failure, or when the sink asks to stop.
+ *
+ * threads <= 0 selects one per hardware thread. */
+
+/* Receives merged output in ascending blocks; return non-zero to abort. */
+typedef int (*heap_sink_fn)(void* ctx, const int* values, size_t n);
+
+/* Sorts data ascending in place, using n ints of scratch memory. */
+int heap_parallel_sort(int* data, size_t n, int threads);
+
+/* Streams the k-way merge of k ascending runs to sink. */
+int heap_merge_runs(const int* const* runs, const size_t* lengths, int k, heap_sink_fn sink, void* ctx);
+
+/* Streams the k-way merge of k files of ascending native-endian ints, each
+ * read from its current position to EOF through its own buffer of
+ * buffer_values ints (at least 1024). A read error on any run fails the
+ * merge. */
+int heap_merge_files(FILE* const* runs, int k, size_t buffer_values, heap_sink_fn sink, void* ctx);
+
+/* External sort of native-endian ints read from `in` until EOF, written
+ * ascending to `out`. memory_bytes bounds the working set: input is cut into
+ * runs of memory_bytes / (2 * sizeof(int)) values, each sorted with
+ * heap_parallel_sort and spilled to a tmpfile(), and the runs are merged with
+ * read buffers sharing the same budget (at least 1024 values per run). */
+int heap_external_sort(FILE* in, FILE* out, size_t memory_bytes, int threads);
+
+#ifdef __cplusplus
+}
+#endif
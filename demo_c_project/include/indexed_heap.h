@@ -0,0 +1,34 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Min-heap with stable handles. push returns a handle (>= 0) that stays valid
+ * until the element is popped or removed; a position map kept up to date by
+ * the sift routines makes decrease_key and remove O(log n). Handles are
+ * recycled. Other functions return 0 on success and -1 on an empty heap, an
+ * invalid handle, an increasing decrease_key, or allocation failure. */
+typedef struct indexed_heap {
+    int* keys;
+    int* handles;
+    int* pos;
+    int* free_handles;
+    int size;
+    int capacity;
+    int free_count;
+} indexed_heap_t;
+
+int indexed_heap_init(indexed_heap_t* heap, int capacity_hint);
+int indexed_heap_push(indexed_heap_t* heap, int key);
+int indexed_heap_pop(indexed_heap_t* heap, int* key, int* handle);
+int indexed_heap_peek(const indexed_heap_t* heap, int* key, int* handle);
+int indexed_heap_contains(const indexed_heap_t* heap, int handle);
+int indexed_heap_key(const indexed_heap_t* heap, int handle, int* key);
+int indexed_heap_decrease_key(indexed_heap_t* heap, int handle, int new_key);
+int indexed_heap_remove(indexed_heap_t* heap, int handle);
+void indexed_heap_destroy(indexed_heap_t* heap);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Min-priority queues of (key, payload) records. Both variants return 0 on
+ * success and -1 on allocation failure or an empty heap.
+ *
+ * kv_heap_t is SoA: keys are contiguous so comparisons only touch the key
+ * array, but every record a sift passes still moves its payload one slot per
+ * level in the parallel array.
+ *
+ * kv_packed_heap_t stores one 64-bit entry per element, (biased key << 32) |
+ * slot, so sifts move a single compact array and payloads never move: they sit
+ * in a slot table that is looked up once per pop. Equal keys pop in slot
+ * order. */
+typedef struct kv_heap {
+    int* keys;
+    void** payloads;
+    int size;
+    int capacity;
+} kv_heap_t;
+
+int kv_heap_init(kv_heap_t* heap, int capacity_hint);
+int kv_heap_push(kv_heap_t* heap, int key, void* payload);
+int kv_heap_pop(kv_heap_t* heap, int* key, void** payload);
+int kv_heap_peek(const kv_heap_t* heap, int* key, void** payload);
+void kv_heap_destroy(kv_heap_t* heap);
+
+typedef struct kv_packed_heap {
+    uint64_t* entries;
+    void** slots;
+    uint32_t* free_slots;
+    int size;
+    int capacity;
+    int free_count;
+} kv_packed_heap_t;
+
+int kv_packed_heap_init(kv_packed_heap_t* heap, int capacity_hint);
+int kv_packed_heap_push(kv_packed_heap_t* heap, int key, void* payload);
+int kv_packed_heap_pop(kv_packed_heap_t* heap, int* key, void** payload);
+int kv_packed_heap_peek(const kv_packed_heap_t* heap, int* key, void** payload);
+void kv_packed_heap_destroy(kv_packed_heap_t* heap);
+
+#ifdef __cplusplus
+}
+#endif
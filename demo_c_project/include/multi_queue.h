@@ -0,0 +1,22 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Thread-safe relaxed min-priority queue over int, see multi_queue.hpp. pop
+ * returns an element close to the minimum rather than the exact minimum.
+ * shards <= 0 selects 2 * hardware threads. push returns -1 on allocation
+ * failure; pop returns -1 when every shard is empty. With concurrent pushes
+ * that -1 is not exact: a value pushed into an already swept shard can be
+ * missed. */
+typedef struct multi_queue_int multi_queue_int_t;
+
+multi_queue_int_t* multi_queue_create(int shards);
+void multi_queue_destroy(multi_queue_int_t* queue);
+int multi_queue_push(multi_queue_int_t* queue, int value);
+int multi_queue_pop(multi_queue_int_t* queue, int* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "dary_heap.hpp"
+
+// Relaxed concurrent priority queue (MultiQueue): c independently locked
+// dary_heap shards. push goes to a random shard; pop compares the cached tops
+// of two random shards and pops from the better one, so the returned element
+// is close to, but not always, the global minimum. Operations never block on a
+// busy shard; they retry elsewhere with try_lock.
+template <typename T, typename Compare = std::less<T>, unsigned D = 4>
+class multi_queue {
+    static_assert(std::is_trivially_copyable<T>::value, "multi_queue caches shard tops in std::atomic<T>");
+
+public:
+    explicit multi_queue(std::size_t shards = 0, const Compare& cmp = Compare())
+        : shard_count_(shards > 0 ? shards : default_shards()), shards_(new shard[shard_count_]), cmp_(cmp) {}
+
+    multi_queue(const multi_queue&) = delete;
+    multi_queue& operator=(const multi_queue&) = delete;
+
+    std::size_t shard_count() const { return shard_count_; }
+
+    void push(const T& value) {
+        while (true) {
+            shard& s = shards_[random_index()];
+            std::unique_lock<std::mutex> guard(s.lock, std::try_to_lock);
+            if (!guard.owns_lock()) continue;
+            s.heap.push(value);
+            publish_top(s);
+            return;
+        }
+    }
+
+    bool try_pop(T& out) {
+        for (int attempt = 0; attempt < 64; ++attempt) {
+            shard* pick = better_of(shards_[random_index()], shards_[random_index()]);
+            if (!pick) continue;
+            if (pop_from(*pick, out)) return true;
+        }
+        // Sampling kept hitting empty or busy shards: sweep all of them before
+        // reporting the queue as empty. Shards are locked one at a time, so
+        // "empty" is only certain when no push is racing with the sweep.
+        for (std::size_t i = 0; i < shard_count_; ++i) {
+            std::lock_guard<std::mutex> guard(shards_[i].lock);
+            if (!shards_[i].heap.empty()) {
+                out = shards_[i].heap.top();
+                shards_[i].heap.pop();
+                publish_top(shards_[i]);
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct alignas(64) shard {
+        std::mutex lock;
+        dary_heap<T, D, Compare> heap;
+        std::atomic<bool> empty{true};
+        std::atomic<T> top{};
+    };
+
+    static std::size_t default_shards() {
+        unsigned threads = std::thread::hardware_concurrency();
+        return 2 * static_cast<std::size_t>(threads > 0 ? threads : 1);
+    }
+
+    static void publish_top(shard& s) {
+        if (!s.heap.empty()) s.top.store(s.heap.top(), std::memory_order_relaxed);
+        s.empty.store(s.heap.empty(), std::memory_order_release);
+    }
+
+    shard* better_of(shard& a, shard& b) const {
+        bool a_empty = a.empty.load(std::memory_order_acquire);
+        bool b_empty = b.empty.load(std::memory_order_acquire);
+        if (a_empty) return b_empty ? nullptr : &b;
+        if (b_empty) return &a;
+        return cmp_(b.top.load(std::memory_order_relaxed), a.top.load(std::memory_order_relaxed)) ? &b : &a;
+    }
+
+    bool pop_from(shard& s, T& out) {
+        std::unique_lock<std::mutex> guard(s.lock, std::try_to_lock);
+        if (!guard.owns_lock() || s.heap.empty()) return false;
+        out = s.heap.top();
+        s.heap.pop();
+        publish_top(s);
+        return true;
+    }
+
+    std::size_t random_index() const {
+        // xorshift64 per thread; quality is irrelevant, only spread matters.
+        thread_local std::uint64_t state =
+            0x9E3779B97F4A7C15ull ^ reinterpret_cast<std::uintptr_t>(&state);
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<std::size_t>(state % shard_count_);
+    }
+
+    std::size_t shard_count_;
+    std::unique_ptr<shard[]> shards_;
+    Compare cmp_;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Monotone integer priority queue (radix heap). Pushes must not go below the
+ * last key returned by pop or peek, as in Dijkstra or event simulation; in exchange push is
+ * O(1) and pop amortised O(log range) bucket moves with no comparisons
+ * between unrelated keys, against O(log n) sifts in min_heap_t. Keys are
+ * sorted into 33 buckets by the highest bit in which they differ from the
+ * last popped key; a pop that empties bucket 0 redistributes the next
+ * non-empty bucket around its minimum.
+ *
+ * Same status conventions as min_heap_*: 0 on success, -1 on allocation
+ * failure, an empty heap, or a push below that key. peek may
+ * redistribute a bucket, so it takes a non-const heap. Start from init (or a
+ * zeroed handle). */
+typedef struct radix_heap_bucket {
+    unsigned* data;
+    int size;
+    int capacity;
+} radix_heap_bucket_t;
+
+typedef struct radix_heap {
+    radix_heap_bucket_t buckets[33];
+    unsigned last;
+    int size;
+} radix_heap_t;
+
+void radix_heap_init(radix_heap_t* heap);
+int radix_heap_push(radix_heap_t* heap, int key);
+int radix_heap_pop(radix_heap_t* heap, int* out);
+int radix_heap_peek(radix_heap_t* heap, int* out);
+void radix_heap_destroy(radix_heap_t* heap);
+
+#ifdef __cplusplus
+}
+#endif
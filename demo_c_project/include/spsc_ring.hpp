@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+// Bounded single-producer/single-consumer ring. The producer owns tail_ and
+// the consumer owns head_; each side keeps a cached copy of the other's index
+// so the shared line is only read when the cached view says the ring is
+// full (producer) or empty (consumer). Capacity is rounded up to a power of
+// two. Bulk push/pop move as many elements as fit and publish them with a
+// single release store.
+template <typename T>
+class spsc_ring {
+    static_assert(std::is_trivially_copyable<T>::value, "spsc_ring copies elements with plain stores");
+
+public:
+    explicit spsc_ring(std::size_t capacity)
+        : mask_(round_up(capacity) - 1), slots_(new T[mask_ + 1]) {}
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    // Producer side.
+    std::size_t free_space() {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) head_cache_ = head_.load(std::memory_order_acquire);
+        return capacity() - (tail - head_cache_);
+    }
+
+    std::size_t push(const T* items, std::size_t n) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t room = capacity() - (tail - head_cache_);
+        if (room < n) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            room = capacity() - (tail - head_cache_);
+        }
+        if (n > room) n = room;
+        for (std::size_t i = 0; i < n; ++i) slots_[(tail + i) & mask_] = items[i];
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side.
+    std::size_t pop(T* out, std::size_t max) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        std::size_t avail = tail_cache_ - head;
+        if (avail < max) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            avail = tail_cache_ - head;
+        }
+        if (max > avail) max = avail;
+        for (std::size_t i = 0; i < max; ++i) out[i] = slots_[(head + i) & mask_];
+        head_.store(head + max, std::memory_order_release);
+        return max;
+    }
+
+    // Either side; exact only when the other side is quiescent.
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    static std::size_t round_up(std::size_t n) {
+        std::size_t c = 2;
+        while (c < n) c *= 2;
+        return c;
+    }
+
+    const std::size_t mask_;
+    const std::unique_ptr<T[]> slots_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t tail_cache_ = 0;
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t head_cache_ = 0;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Type-generic heaps for keys that do not fit the int min_heap_* API.
+ *
+ * TYPED_HEAP_DECLARE(name, T) declares a handle name##_t and its functions;
+ * the instantiations below are generated from the C++ template in
+ * typed_heap.hpp, where the comparator is a template argument and inlines
+ * into the sift loops (a max-heap is the same template with std::greater).
+ * Other key types or comparators can be instantiated in any C++ file with
+ * TYPED_HEAP_DEFINE (wrap the matching DECLARE in extern "C" when it is
+ * used from C++). T must be trivially copyable; for float/double, NaN
+ * keys have no defined position.
+ *
+ * Start from init (or a zeroed handle); the buffer grows from 10 by doubling.
+ * All int-returning functions report 0 on success and -1 on allocation
+ * failure or an empty heap, so every value of T is a valid key. */
+#define TYPED_HEAP_DECLARE(name, T)                                   \
+    typedef struct name {                                             \
+        T* data;                                                      \
+        int size;                                                     \
+        int capacity;                                                 \
+    } name##_t;                                                       \
+    int name##_init(name##_t* heap, int capacity_hint);               \
+    int name##_reserve(name##_t* heap, int capacity);                 \
+    int name##_push(name##_t* heap, T value);                         \
+    int name##_push_many(name##_t* heap, const T* values, int n);     \
+    int name##_pop(name##_t* heap, T* out);                           \
+    int name##_peek(const name##_t* heap, T* out);                    \
+    void name##_destroy(name##_t* heap);
+
+TYPED_HEAP_DECLARE(i32_min_heap, int32_t)
+TYPED_HEAP_DECLARE(i32_max_heap, int32_t)
+TYPED_HEAP_DECLARE(i64_min_heap, int64_t)
+TYPED_HEAP_DECLARE(i64_max_heap, int64_t)
+TYPED_HEAP_DECLARE(f32_min_heap, float)
+TYPED_HEAP_DECLARE(f32_max_heap, float)
+TYPED_HEAP_DECLARE(f64_min_heap, double)
+TYPED_HEAP_DECLARE(f64_max_heap, double)
+
+#ifdef __cplusplus
+}
+#endif
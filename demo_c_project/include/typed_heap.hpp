@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdlib>
+#include <functional>
+#include <type_traits>
+
+#include "dary_heap.hpp"
+#include "typed_heap.h"
+
+namespace typed_heap {
+
+// Implementation behind TYPED_HEAP_DEFINE. Heap is a handle declared with
+// TYPED_HEAP_DECLARE; the array is laid out as a 4-ary heap via the raw
+// dary_heap helpers, so Compare is resolved at compile time.
+template <typename Heap, typename T, typename Compare>
+struct ops {
+    static_assert(std::is_trivially_copyable<T>::value, "typed heaps store keys in realloc'd memory");
+    using layout = dary_heap<T, 4, Compare>;
+
+    static int set_capacity(Heap* heap, int capacity) {
+        T* data = static_cast<T*>(std::realloc(heap->data, static_cast<std::size_t>(capacity) * sizeof(T)));
+        if (!data) return -1;
+        heap->data = data;
+        heap->capacity = capacity;
+        return 0;
+    }
+
+    static int grow(Heap* heap, int needed) {
+        if (needed <= heap->capacity) return 0;
+        if (needed < 0) return -1;
+        long long capacity = heap->capacity > 0 ? heap->capacity : 10;
+        while (capacity < needed) capacity *= 2;
+        if (capacity > 0x7fffffff) capacity = needed;
+        return set_capacity(heap, static_cast<int>(capacity));
+    }
+
+    static int init(Heap* heap, int capacity_hint) {
+        heap->data = nullptr;
+        heap->size = 0;
+        heap->capacity = 0;
+        return capacity_hint > 0 ? set_capacity(heap, capacity_hint) : 0;
+    }
+
+    static int reserve(Heap* heap, int capacity) {
+        return capacity <= heap->capacity ? 0 : set_capacity(heap, capacity);
+    }
+
+    static int push(Heap* heap, T value) {
+        if (grow(heap, heap->size + 1) != 0) return -1;
+        heap->data[heap->size] = value;
+        layout::sift_up(heap->data, static_cast<std::size_t>(heap->size), Compare());
+        heap->size++;
+        return 0;
+    }
+
+    static int push_many(Heap* heap, const T* values, int n) {
+        if (n <= 0) return 0;
+        if (grow(heap, heap->size + n) != 0) return -1;
+        int old_size = heap->size;
+        for (int i = 0; i < n; ++i) heap->data[old_size + i] = values[i];
+        heap->size = old_size + n;
+        if (n >= old_size) {
+            layout::heapify(heap->data, static_cast<std::size_t>(heap->size), Compare());
+        } else {
+            for (int i = old_size; i < heap->size; ++i) {
+                layout::sift_up(heap->data, static_cast<std::size_t>(i), Compare());
+            }
+        }
+        return 0;
+    }
+
+    static int pop(Heap* heap, T* out) {
+        if (heap->size == 0) return -1;
+        layout::pop_root(heap->data, static_cast<std::size_t>(heap->size), Compare());
+        heap->size--;
+        *out = heap->data[heap->size];
+        return 0;
+    }
+
+    static int peek(const Heap* heap, T* out) {
+        if (heap->size == 0) return -1;
+        *out = heap->data[0];
+        return 0;
+    }
+
+    static void destroy(Heap* heap) {
+        std::free(heap->data);
+        heap->data = nullptr;
+        heap->size = 0;
+        heap->capacity = 0;
+    }
+};
+
+}  // namespace typed_heap
+
+/* Defines the functions declared by TYPED_HEAP_DECLARE(name, T) with C
+ * linkage, ordering keys by the function object type Compare (a strict weak
+ * order; the root is the element no other compares less than). Use once per
+ * name, at namespace scope in a C++ file. */
+#define TYPED_HEAP_DEFINE(name, T, Compare)                                                                   \
+    extern "C" int name##_init(name##_t* heap, int capacity_hint) {                                           \
+        return typed_heap::ops<name##_t, T, Compare>::init(heap, capacity_hint);                              \
+    }                                                                                                         \
+    extern "C" int name##_reserve(name##_t* heap, int capacity) {                                             \
+        return typed_heap::ops<name##_t, T, Compare>::reserve(heap, capacity);                                \
+    }                                                                                                         \
+    extern "C" int name##_push(name##_t* heap, T value) {                                                     \
+        return typed_heap::ops<name##_t, T, Compare>::push(heap, value);                                      \
+    }                                                                                                         \
+    extern "C" int name##_push_many(name##_t* heap, const T* values, int n) {                                 \
+        return typed_heap::ops<name##_t, T, Compare>::push_many(heap, values, n);                             \
+    }                                                                                                         \
+    extern "C" int name##_pop(name##_t* heap, T* out) {                                                       \
+        return typed_heap::ops<name##_t, T, Compare>::pop(heap, out);                                         \
+    }                                                                                                         \
+    extern "C" int name##_peek(const name##_t* heap, T* out) {                                                \
+        return typed_heap::ops<name##_t, T, Compare>::peek(heap, out);                                        \
+    }                                                                                                         \
+    extern "C" void name##_destroy(name##_t* heap) { typed_heap::ops<name##_t, T, Compare>::destroy(heap); }
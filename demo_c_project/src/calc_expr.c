@@ -0,0 +1,385 @@
+#include "calc_expr.h"
+#include "calc_expr_internal.h"
+#include "calculator.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ---- compiler ---- */
+
+typedef struct parser {
+    const char* pos;
+    calc_expr_t* expr;
+    int capacity;
+    int depth;
+    int nesting;
+    const char* error;
+} parser_t;
+
+static void skip_space(parser_t* p) {
+    while (isspace((unsigned char)*p->pos)) p->pos++;
+}
+
+static int fail(parser_t* p, const char* message) {
+    if (!p->error) p->error = message;
+    return -1;
+}
+
+static int emit(parser_t* p, int op, int operand) {
+    calc_expr_t* e = p->expr;
+    if (e->code_size == p->capacity) {
+        int capacity = p->capacity == 0 ? 16 : p->capacity * 2;
+        calc_expr_insn_t* code = (calc_expr_insn_t*)realloc(e->code, (size_t)capacity * sizeof(*code));
+        if (!code) return fail(p, "out of memory");
+        e->code = code;
+        p->capacity = capacity;
+    }
+    e->code[e->code_size].op = op;
+    e->code[e->code_size].operand = operand;
+    e->code_size++;
+    if (op == CALC_EXPR_OP_CONST || op == CALC_EXPR_OP_VAR) {
+        if (++p->depth > CALC_EXPR_MAX_DEPTH) return fail(p, "operand stack overflow");
+        if (p->depth > e->max_depth) e->max_depth = p->depth;
+    } else if (op != CALC_EXPR_OP_NEG) {
+        p->depth--;
+    }
+    return 0;
+}
+
+static calc_expr_insn_t* last_insn(parser_t* p, int back) {
+    calc_expr_t* e = p->expr;
+    return e->code_size > back ? &e->code[e->code_size - 1 - back] : NULL;
+}
+
+/* Operands are emitted immediately before their operator, so a constant
+ * sub-expression always ends in CONST instructions that can be folded in
+ * place. Division by a constant zero is left unfolded so evaluation still
+ * raises the error flag. */
+static int emit_op(parser_t* p, int op) {
+    calc_expr_insn_t* rhs = last_insn(p, 0);
+    if (op == CALC_EXPR_OP_NEG) {
+        if (rhs && rhs->op == CALC_EXPR_OP_CONST) {
+            rhs->operand = (int)(0u - (unsigned)rhs->operand);
+            return 0;
+        }
+        return emit(p, op, 0);
+    }
+    calc_expr_insn_t* lhs = last_insn(p, 1);
+    if (lhs && rhs && lhs->op == CALC_EXPR_OP_CONST && rhs->op == CALC_EXPR_OP_CONST) {
+        int error = 0;
+        int value = calc_expr_apply(op, lhs->operand, rhs->operand, &error);
+        if (!error) {
+            lhs->operand = value;
+            p->expr->code_size--;
+            p->depth--;
+            return 0;
+        }
+    }
+    return emit(p, op, 0);
+}
+
+static int var_index(parser_t* p, const char* name, size_t len) {
+    calc_expr_t* e = p->expr;
+    for (int i = 0; i < e->var_count; ++i) {
+        if (strlen(e->var_names[i]) == len && strncmp(e->var_names[i], name, len) == 0) return i;
+    }
+    char** names = (char**)realloc(e->var_names, (size_t)(e->var_count + 1) * sizeof(char*));
+    if (!names) return fail(p, "out of memory");
+    e->var_names = names;
+    char* copy = (char*)malloc(len + 1);
+    if (!copy) return fail(p, "out of memory");
+    memcpy(copy, name, len);
+    copy[len] = '\0';
+    e->var_names[e->var_count] = copy;
+    return e->var_count++;
+}
+
+static int parse_expr(parser_t* p);
+
+/* `negate` is set for a literal directly after unary minus, so that
+ * -2147483648 (INT_MIN) can be written even though 2147483648 cannot. */
+static int parse_primary(parser_t* p, int negate) {
+    skip_space(p);
+    const char* start = p->pos;
+    if (isdigit((unsigned char)*start)) {
+        long long limit = negate ? -(long long)INT_MIN : INT_MAX;
+        long long value = 0;
+        while (isdigit((unsigned char)*p->pos)) {
+            value = value * 10 + (*p->pos - '0');
+            if (value > limit) return fail(p, "integer literal out of range");
+            p->pos++;
+        }
+        return emit(p, CALC_EXPR_OP_CONST, (int)(negate ? -value : value));
+    }
+    if (negate) {
+        if (parse_primary(p, 0) != 0) return -1;
+        return emit_op(p, CALC_EXPR_OP_NEG);
+    }
+    if (isalpha((unsigned char)*start) || *start == '_') {
+        while (isalnum((unsigned char)*p->pos) || *p->pos == '_') p->pos++;
+        int index = var_index(p, start, (size_t)(p->pos - start));
+        return index < 0 ? -1 : emit(p, CALC_EXPR_OP_VAR, index);
+    }
+    if (*start == '(') {
+        if (++p->nesting > CALC_EXPR_MAX_NESTING) return fail(p, "expression nests too deeply");
+        p->pos++;
+        if (parse_expr(p) != 0) return -1;
+        skip_space(p);
+        if (*p->pos != ')') return fail(p, "expected ')'");
+        p->pos++;
+        p->nesting--;
+        return 0;
+    }
+    return fail(p, *start ? "unexpected character" : "unexpected end of expression");
+}
+
+static int parse_unary(parser_t* p) {
+    skip_space(p);
+    if (*p->pos == '-' || *p->pos == '+') {
+        if (++p->nesting > CALC_EXPR_MAX_NESTING) return fail(p, "expression nests too deeply");
+        int negate = *p->pos == '-';
+        p->pos++;
+        skip_space(p);
+        int status;
+        if (negate && *p->pos != '-' && *p->pos != '+') {
+            status = parse_primary(p, 1);
+        } else if (parse_unary(p) != 0) {
+            status = -1;
+        } else {
+            status = negate ? emit_op(p, CALC_EXPR_OP_NEG) : 0;
+        }
+        p->nesting--;
+        return status;
+    }
+    return parse_primary(p, 0);
+}
+
+static int parse_term(parser_t* p) {
+    if (parse_unary(p) != 0) return -1;
+    while (1) {
+        skip_space(p);
+        char c = *p->pos;
+        int op = c == '*' ? CALC_EXPR_OP_MUL : c == '/' ? CALC_EXPR_OP_DIV : c == '%' ? CALC_EXPR_OP_MOD : -1;
+        if (op < 0) return 0;
+        p->pos++;
+        if (parse_unary(p) != 0 || emit_op(p, op) != 0) return -1;
+    }
+}
+
+static int parse_expr(parser_t* p) {
+    if (parse_term(p) != 0) return -1;
+    while (1) {
+        skip_space(p);
+        char c = *p->pos;
+        int op = c == '+' ? CALC_EXPR_OP_ADD : c == '-' ? CALC_EXPR_OP_SUB : -1;
+        if (op < 0) return 0;
+        p->pos++;
+        if (parse_term(p) != 0 || emit_op(p, op) != 0) return -1;
+    }
+}
+
+calc_expr_t* calc_expr_compile(const char* source, char* error, size_t error_size) {
+    calc_expr_t* expr = (calc_expr_t*)calloc(1, sizeof(calc_expr_t));
+    if (!expr) return NULL;
+    parser_t p = {source, expr, 0, 0, 0, NULL};
+    if (parse_expr(&p) == 0) {
+        skip_space(&p);
+        if (*p.pos != '\0') fail(&p, "unexpected trailing input");
+    }
+    if (p.error) {
+        if (error && error_size > 0) {
+            snprintf(error, error_size, "%s at offset %d", p.error, (int)(p.pos - source));
+        }
+        calc_expr_destroy(expr);
+        return NULL;
+    }
+    return expr;
+}
+
+void calc_expr_destroy(calc_expr_t* expr) {
+    if (!expr) return;
+    for (int i = 0; i < expr->var_count; ++i) free(expr->var_names[i]);
+    free(expr->var_names);
+    free(expr->code);
+    free(expr);
+}
+
+int calc_expr_var_count(const calc_expr_t* expr) {
+    return expr->var_count;
+}
+
+const char* calc_expr_var_name(const calc_expr_t* expr, int index) {
+    return index >= 0 && index < expr->var_count ? expr->var_names[index] : NULL;
+}
+
+int calc_expr_var_index(const calc_expr_t* expr, const char* name) {
+    for (int i = 0; i < expr->var_count; ++i) {
+        if (strcmp(expr->var_names[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+int calc_expr_code_size(const calc_expr_t* expr) {
+    return expr->code_size;
+}
+
+/* ---- row interpreter ---- */
+
+int calc_expr_eval(const calc_expr_t* expr, const int* vars, int* error) {
+    int stack[CALC_EXPR_MAX_DEPTH];
+    int depth = 0;
+    int err = 0;
+    const calc_expr_insn_t* code = expr->code;
+    for (int pc = 0; pc < expr->code_size; ++pc) {
+        switch (code[pc].op) {
+        case CALC_EXPR_OP_CONST:
+            stack[depth++] = code[pc].operand;
+            break;
+        case CALC_EXPR_OP_VAR:
+            stack[depth++] = vars[code[pc].operand];
+            break;
+        case CALC_EXPR_OP_NEG:
+            stack[depth - 1] = (int)(0u - (unsigned)stack[depth - 1]);
+            break;
+        default:
+            depth--;
+            stack[depth - 1] = calc_expr_apply(code[pc].op, stack[depth - 1], stack[depth], &err);
+            break;
+        }
+    }
+    if (error) *error = err;
+    return stack[0];
+}
+
+/* ---- column evaluator ---- */
+
+#define CALC_EXPR_BLOCK 256
+
+/* A stack entry is either a constant or a pointer to BLOCK values, which may
+ * be an input column slice or one of the per-depth scratch blocks. */
+typedef struct column_slot {
+    const int* values;
+    int constant;
+} column_slot_t;
+
+static const int* materialize(column_slot_t* slot, int* scratch, size_t m) {
+    if (!slot->values) {
+        for (size_t i = 0; i < m; ++i) scratch[i] = slot->constant;
+        slot->values = scratch;
+    }
+    return slot->values;
+}
+
+static void set_all_bits(unsigned char* bits, size_t m) {
+    memset(bits, 0xff, m / 8);
+    if (m % 8) bits[m / 8] |= (unsigned char)((1u << (m % 8)) - 1);
+}
+
+static void apply_block(int op, column_slot_t* lhs, column_slot_t rhs, int* scratch, unsigned char* block_bits,
+                        size_t m) {
+    unsigned char bits[CALC_EXPR_BLOCK / 8];
+    int commutes = op == CALC_EXPR_OP_ADD || op == CALC_EXPR_OP_MUL;
+    if (!lhs->values && commutes) {
+        column_slot_t tmp = *lhs;
+        *lhs = rhs;
+        rhs = tmp;
+    }
+    if (!rhs.values) {
+        const int* a = materialize(lhs, scratch, m);
+        int zero = 0;
+        switch (op) {
+        case CALC_EXPR_OP_ADD:
+            add_scalar_n(a, rhs.constant, scratch, m);
+            break;
+        case CALC_EXPR_OP_SUB:
+            subtract_scalar_n(a, rhs.constant, scratch, m);
+            break;
+        case CALC_EXPR_OP_MUL:
+            multiply_scalar_n(a, rhs.constant, scratch, m);
+            break;
+        case CALC_EXPR_OP_DIV:
+            zero = divide_scalar_n(a, rhs.constant, scratch, m);
+            break;
+        default:
+            zero = mod_scalar_n(a, rhs.constant, scratch, m);
+            break;
+        }
+        if (zero) set_all_bits(block_bits, m);
+    } else {
+        const int* a = materialize(lhs, scratch, m);
+        switch (op) {
+        case CALC_EXPR_OP_ADD:
+            add_n(a, rhs.values, scratch, m);
+            break;
+        case CALC_EXPR_OP_SUB:
+            subtract_n(a, rhs.values, scratch, m);
+            break;
+        case CALC_EXPR_OP_MUL:
+            multiply_n(a, rhs.values, scratch, m);
+            break;
+        default:
+            if ((op == CALC_EXPR_OP_DIV ? divide_n : mod_n)(a, rhs.values, scratch, bits, m)) {
+                for (size_t i = 0; i < (m + 7) / 8; ++i) block_bits[i] |= bits[i];
+            }
+            break;
+        }
+    }
+    lhs->values = scratch;
+}
+
+int calc_expr_eval_n(const calc_expr_t* expr, const int* const* columns, int* out, unsigned char* error_bits,
+                     size_t n) {
+    int* scratch = (int*)malloc((size_t)expr->max_depth * CALC_EXPR_BLOCK * sizeof(int));
+    if (!scratch) return -1;
+    column_slot_t stack[CALC_EXPR_MAX_DEPTH];
+    unsigned char block_bits[CALC_EXPR_BLOCK / 8];
+    int any_error = 0;
+    for (size_t base = 0; base < n; base += CALC_EXPR_BLOCK) {
+        size_t m = n - base < CALC_EXPR_BLOCK ? n - base : CALC_EXPR_BLOCK;
+        int depth = 0;
+        memset(block_bits, 0, sizeof(block_bits));
+        for (int pc = 0; pc < expr->code_size; ++pc) {
+            const calc_expr_insn_t* insn = &expr->code[pc];
+            switch (insn->op) {
+            case CALC_EXPR_OP_CONST:
+                stack[depth].values = NULL;
+                stack[depth].constant = insn->operand;
+                depth++;
+                break;
+            case CALC_EXPR_OP_VAR:
+                stack[depth].values = columns[insn->operand] + base;
+                depth++;
+                break;
+            case CALC_EXPR_OP_NEG: {
+                if (!stack[depth - 1].values) {
+                    stack[depth - 1].constant = (int)(0u - (unsigned)stack[depth - 1].constant);
+                    break;
+                }
+                int* dst = scratch + (size_t)(depth - 1) * CALC_EXPR_BLOCK;
+                multiply_scalar_n(stack[depth - 1].values, -1, dst, m);
+                stack[depth - 1].values = dst;
+                break;
+            }
+            default:
+                depth--;
+                apply_block(insn->op, &stack[depth - 1], stack[depth],
+                            scratch + (size_t)(depth - 1) * CALC_EXPR_BLOCK, block_bits, m);
+                break;
+            }
+        }
+        if (stack[0].values) {
+            memcpy(out + base, stack[0].values, m * sizeof(int));
+        } else {
+            for (size_t i = 0; i < m; ++i) out[base + i] = stack[0].constant;
+        }
+        for (size_t i = 0; i < (m + 7) / 8; ++i) {
+            if (block_bits[i]) any_error = 1;
+            if (error_bits) error_bits[base / 8 + i] = block_bits[i];
+        }
+    }
+    free(scratch);
+    return any_error;
+}
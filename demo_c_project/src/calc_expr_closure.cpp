@@ -0,0 +1,228 @@
+#include "calc_expr.h"
+#include "calc_expr_internal.h"
+
+#include <cstring>
+#include <new>
+#include <vector>
+
+// Closure compilation: the bytecode is turned into a tree of nodes whose
+// function pointers are template instances specialised on the operator and on
+// whether each operand is a constant, a variable or another node. Evaluation
+// is a chain of direct calls with operands in registers, without the
+// interpreter's dispatch switch or operand stack, and without emitting machine
+// code at runtime.
+namespace {
+
+enum { KIND_CONST, KIND_VAR, KIND_NODE };
+
+struct node;
+
+// Row access reads vars[index]; column access reads columns[index][row].
+struct row_access {
+    const int* vars;
+    int load(int index) const { return vars[index]; }
+};
+
+struct column_access {
+    const int* const* columns;
+    std::size_t row;
+    int load(int index) const { return columns[index][row]; }
+};
+
+using row_fn = int (*)(const node*, const row_access&, int&);
+using column_fn = int (*)(const node*, const column_access&, int&);
+
+struct node {
+    row_fn eval_row;
+    column_fn eval_column;
+    int lhs_imm;
+    int rhs_imm;
+    const node* lhs;
+    const node* rhs;
+};
+
+template <typename Access>
+int call(const node* n, const Access& access, int& err);
+
+template <>
+int call<row_access>(const node* n, const row_access& access, int& err) {
+    return n->eval_row(n, access, err);
+}
+
+template <>
+int call<column_access>(const node* n, const column_access& access, int& err) {
+    return n->eval_column(n, access, err);
+}
+
+template <int Kind, typename Access>
+inline int fetch(const node* child, int imm, const Access& access, int& err) {
+    if (Kind == KIND_CONST) return imm;
+    if (Kind == KIND_VAR) return access.load(imm);
+    return call(child, access, err);
+}
+
+template <int Op, int L, int R, typename Access>
+int eval_binary(const node* n, const Access& access, int& err) {
+    int lhs = fetch<L>(n->lhs, n->lhs_imm, access, err);
+    int rhs = fetch<R>(n->rhs, n->rhs_imm, access, err);
+    return calc_expr_apply(Op, lhs, rhs, &err);
+}
+
+template <int K, typename Access>
+int eval_negate(const node* n, const Access& access, int& err) {
+    return static_cast<int>(0u - static_cast<unsigned>(fetch<K>(n->lhs, n->lhs_imm, access, err)));
+}
+
+template <int K, typename Access>
+int eval_leaf(const node* n, const Access& access, int& err) {
+    return fetch<K>(nullptr, n->lhs_imm, access, err);
+}
+
+template <int Op, int L, int R>
+void bind_binary(node& n) {
+    n.eval_row = &eval_binary<Op, L, R, row_access>;
+    n.eval_column = &eval_binary<Op, L, R, column_access>;
+}
+
+template <int Op, int L>
+void bind_rhs(node& n, int rhs_kind) {
+    switch (rhs_kind) {
+    case KIND_CONST: bind_binary<Op, L, KIND_CONST>(n); break;
+    case KIND_VAR: bind_binary<Op, L, KIND_VAR>(n); break;
+    default: bind_binary<Op, L, KIND_NODE>(n); break;
+    }
+}
+
+template <int Op>
+void bind_op(node& n, int lhs_kind, int rhs_kind) {
+    switch (lhs_kind) {
+    case KIND_CONST: bind_rhs<Op, KIND_CONST>(n, rhs_kind); break;
+    case KIND_VAR: bind_rhs<Op, KIND_VAR>(n, rhs_kind); break;
+    default: bind_rhs<Op, KIND_NODE>(n, rhs_kind); break;
+    }
+}
+
+template <int K>
+void bind_unary(node& n, bool negate) {
+    n.eval_row = negate ? &eval_negate<K, row_access> : &eval_leaf<K, row_access>;
+    n.eval_column = negate ? &eval_negate<K, column_access> : &eval_leaf<K, column_access>;
+}
+
+// An operand is either inlined into its parent (constant or variable) or a
+// child node.
+struct operand {
+    int kind;
+    int imm;
+    int node_index;
+};
+
+}  // namespace
+
+struct calc_expr_closure {
+    std::vector<node> nodes;
+    int root;
+};
+
+extern "C" {
+
+calc_expr_closure_t* calc_expr_closure_compile(const calc_expr_t* expr) {
+    auto* closure = new (std::nothrow) calc_expr_closure_t;
+    if (!closure) return nullptr;
+    try {
+        // Child pointers are fixed up after the vector stops growing.
+        closure->nodes.reserve(static_cast<std::size_t>(expr->code_size) + 1);
+        std::vector<operand> stack;
+        std::vector<int> lhs_index, rhs_index;
+        auto add_node = [&](int l, int r) {
+            closure->nodes.push_back(node{});
+            lhs_index.push_back(l);
+            rhs_index.push_back(r);
+            return static_cast<int>(closure->nodes.size() - 1);
+        };
+        for (int pc = 0; pc < expr->code_size; ++pc) {
+            const calc_expr_insn_t& insn = expr->code[pc];
+            if (insn.op == CALC_EXPR_OP_CONST || insn.op == CALC_EXPR_OP_VAR) {
+                stack.push_back(operand{insn.op == CALC_EXPR_OP_CONST ? KIND_CONST : KIND_VAR, insn.operand, -1});
+                continue;
+            }
+            if (insn.op == CALC_EXPR_OP_NEG) {
+                operand x = stack.back();
+                int idx = add_node(x.node_index, -1);
+                node& n = closure->nodes[idx];
+                n.lhs_imm = x.imm;
+                switch (x.kind) {
+                case KIND_CONST: bind_unary<KIND_CONST>(n, true); break;
+                case KIND_VAR: bind_unary<KIND_VAR>(n, true); break;
+                default: bind_unary<KIND_NODE>(n, true); break;
+                }
+                stack.back() = operand{KIND_NODE, 0, idx};
+                continue;
+            }
+            operand r = stack.back();
+            stack.pop_back();
+            operand l = stack.back();
+            int idx = add_node(l.node_index, r.node_index);
+            node& n = closure->nodes[idx];
+            n.lhs_imm = l.imm;
+            n.rhs_imm = r.imm;
+            switch (insn.op) {
+            case CALC_EXPR_OP_ADD: bind_op<CALC_EXPR_OP_ADD>(n, l.kind, r.kind); break;
+            case CALC_EXPR_OP_SUB: bind_op<CALC_EXPR_OP_SUB>(n, l.kind, r.kind); break;
+            case CALC_EXPR_OP_MUL: bind_op<CALC_EXPR_OP_MUL>(n, l.kind, r.kind); break;
+            case CALC_EXPR_OP_DIV: bind_op<CALC_EXPR_OP_DIV>(n, l.kind, r.kind); break;
+            default: bind_op<CALC_EXPR_OP_MOD>(n, l.kind, r.kind); break;
+            }
+            stack.back() = operand{KIND_NODE, 0, idx};
+        }
+        operand top = stack.back();
+        if (top.kind != KIND_NODE) {
+            // A bare constant or variable still needs a root node to call.
+            int idx = add_node(-1, -1);
+            node& n = closure->nodes[idx];
+            n.lhs_imm = top.imm;
+            if (top.kind == KIND_CONST) {
+                bind_unary<KIND_CONST>(n, false);
+            } else {
+                bind_unary<KIND_VAR>(n, false);
+            }
+            top.node_index = idx;
+        }
+        for (std::size_t i = 0; i < closure->nodes.size(); ++i) {
+            closure->nodes[i].lhs = lhs_index[i] >= 0 ? &closure->nodes[lhs_index[i]] : nullptr;
+            closure->nodes[i].rhs = rhs_index[i] >= 0 ? &closure->nodes[rhs_index[i]] : nullptr;
+        }
+        closure->root = top.node_index;
+    } catch (const std::bad_alloc&) {
+        delete closure;
+        return nullptr;
+    }
+    return closure;
+}
+
+void calc_expr_closure_destroy(calc_expr_closure_t* closure) {
+    delete closure;
+}
+
+int calc_expr_closure_eval(const calc_expr_closure_t* closure, const int* vars, int* error) {
+    const node* root = &closure->nodes[closure->root];
+    int err = 0;
+    int v = root->eval_row(root, row_access{vars}, err);
+    if (error) *error = err;
+    return v;
+}
+
+int calc_expr_closure_eval_n(const calc_expr_closure_t* closure, const int* const* columns, int* out,
+                             unsigned char* error_bits, size_t n) {
+    const node* root = &closure->nodes[closure->root];
+    int any = 0;
+    if (error_bits) std::memset(error_bits, 0, (n + 7) / 8);
+    for (size_t i = 0; i < n; ++i) {
+        int err = 0;
+        out[i] = root->eval_column(root, column_access{columns, i}, err);
+        any |= err;
+        if (error_bits) error_bits[i / 8] |= static_cast<unsigned char>(err << (i % 8));
+    }
+    return any;
+}
+
+}
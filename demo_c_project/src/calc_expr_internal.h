@@ -0,0 +1,29 @@
+#pragma once
+
+#include "calc_expr.h"
+#include "calc_expr_ops.h"
+
+/* Bytecode shared by the interpreter in calc_expr.c and other evaluators of
+ * compiled expressions. Programs are postfix: operands are pushed, operators
+ * pop two (NEG one) and push the result. */
+/* Bound on nested parentheses and unary signs, so hostile config text fails
+ * to compile instead of overflowing the C stack in the recursive descent. */
+#define CALC_EXPR_MAX_NESTING 256
+/* Operand stack size implied by that bound: each open parenthesis can leave at
+ * most a pending sum and a pending product below it, and the innermost level
+ * holds at most three values (a + b * c), so compiling never hits this limit
+ * on its own. */
+#define CALC_EXPR_MAX_DEPTH (2 * CALC_EXPR_MAX_NESTING + 3)
+
+typedef struct calc_expr_insn {
+    int op;
+    int operand; /* constant value or variable index */
+} calc_expr_insn_t;
+
+struct calc_expr {
+    calc_expr_insn_t* code;
+    int code_size;
+    int max_depth;
+    char** var_names;
+    int var_count;
+};
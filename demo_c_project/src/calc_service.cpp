@@ -0,0 +1,262 @@
+#include "calc_service.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "calculator.h"
+#include "spsc_ring.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Requests taken from one ring per pass; sized so the scratch arrays stay in L1.
+constexpr std::size_t kBatch = 256;
+// Empty passes before a worker parks on its condition variable.
+constexpr int kSpinPasses = 64;
+
+struct worker;
+
+struct scratch {
+    calc_sqe_t sqes[kBatch];
+    calc_cqe_t cqes[kBatch];
+    int index[kBatch];
+    int a[kBatch];
+    int b[kBatch];
+    int out[kBatch];
+    unsigned char error_bits[kBatch / 8];
+};
+
+// Groups the batch by op and runs each group through one array kernel call.
+void run_batch(scratch& s, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        s.cqes[i].user_data = s.sqes[i].user_data;
+        s.cqes[i].result = 0;
+        s.cqes[i].error = s.sqes[i].op >= CALC_SVC_OP_ADD && s.sqes[i].op <= CALC_SVC_OP_MOD ? 0 : -1;
+    }
+    for (int op = CALC_SVC_OP_ADD; op <= CALC_SVC_OP_MOD; ++op) {
+        std::size_t m = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (s.sqes[i].op != op) continue;
+            s.index[m] = static_cast<int>(i);
+            s.a[m] = s.sqes[i].a;
+            s.b[m] = s.sqes[i].b;
+            ++m;
+        }
+        if (m == 0) continue;
+        bool checked = op == CALC_SVC_OP_DIVIDE || op == CALC_SVC_OP_MOD;
+        if (checked) std::memset(s.error_bits, 0, (m + 7) / 8);
+        switch (op) {
+            case CALC_SVC_OP_ADD: add_n(s.a, s.b, s.out, m); break;
+            case CALC_SVC_OP_SUBTRACT: subtract_n(s.a, s.b, s.out, m); break;
+            case CALC_SVC_OP_MULTIPLY: multiply_n(s.a, s.b, s.out, m); break;
+            case CALC_SVC_OP_DIVIDE: divide_n(s.a, s.b, s.out, s.error_bits, m); break;
+            case CALC_SVC_OP_MOD: mod_n(s.a, s.b, s.out, s.error_bits, m); break;
+        }
+        for (std::size_t j = 0; j < m; ++j) {
+            calc_cqe_t& cqe = s.cqes[s.index[j]];
+            cqe.result = s.out[j];
+            if (checked) cqe.error = (s.error_bits[j / 8] >> (j % 8)) & 1;
+        }
+    }
+}
+
+}  // namespace
+
+struct calc_client {
+    calc_client(calc_service* service, worker* owner, std::size_t entries)
+        : service(service), owner(owner), sq(entries), cq(entries) {}
+
+    calc_service* service;
+    worker* owner;
+    spsc_ring<calc_sqe_t> sq;
+    spsc_ring<calc_cqe_t> cq;
+};
+
+namespace {
+
+struct worker {
+    std::thread thread;
+    // Held while the worker serves its clients, so removing a client under
+    // it guarantees the worker is no longer touching that client's rings.
+    std::mutex clients_lock;
+    std::vector<calc_client*> clients;
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+    std::atomic<bool> sleeping{false};
+
+    void notify() {
+        // Pairs with the fence in park(): either the submitter sees the flag
+        // or the worker sees the new tail before it blocks.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!sleeping.load(std::memory_order_relaxed)) return;
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        wake.notify_one();
+    }
+};
+
+// Moves one batch from the client's submission ring to its completion ring,
+// never taking more requests than there are free completion slots.
+bool serve(calc_client* client, scratch& s) {
+    std::size_t room = std::min(kBatch, client->cq.free_space());
+    if (room == 0) return false;
+    std::size_t n = client->sq.pop(s.sqes, room);
+    if (n == 0) return false;
+    run_batch(s, n);
+    client->cq.push(s.cqes, n);
+    return true;
+}
+
+void pin_to_cpu(std::thread& thread, unsigned cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+    (void)thread;
+    (void)cpu;
+#endif
+}
+
+}  // namespace
+
+struct calc_service {
+    explicit calc_service(std::size_t count) : workers(count) {}
+
+    void run(worker& w) {
+        std::unique_ptr<scratch> s(new scratch);
+        int idle = 0;
+        while (!stop.load(std::memory_order_acquire)) {
+            bool busy = false;
+            {
+                std::lock_guard<std::mutex> guard(w.clients_lock);
+                for (calc_client* client : w.clients) busy |= serve(client, *s);
+            }
+            if (busy) {
+                idle = 0;
+            } else if (++idle < kSpinPasses) {
+                std::this_thread::yield();
+            } else {
+                park(w);
+                idle = 0;
+            }
+        }
+    }
+
+    void park(worker& w) {
+        std::unique_lock<std::mutex> sleep(w.sleep_lock);
+        w.sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool pending = stop.load(std::memory_order_acquire);
+        {
+            std::lock_guard<std::mutex> guard(w.clients_lock);
+            for (calc_client* client : w.clients) pending |= !client->sq.empty() && client->cq.free_space() > 0;
+        }
+        // Submissions always wake the worker through notify(); the timeout
+        // covers a client that drains a full completion ring with reap().
+        if (!pending) w.wake.wait_for(sleep, std::chrono::milliseconds(1));
+        w.sleeping.store(false, std::memory_order_relaxed);
+    }
+
+    std::vector<worker> workers;
+    std::atomic<bool> stop{false};
+    std::atomic<unsigned> next_worker{0};
+};
+
+extern "C" {
+
+calc_service_t* calc_service_create(int workers, int pin) {
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = 1;
+    std::size_t count = workers > 0 ? static_cast<std::size_t>(workers) : hw;
+    calc_service* service = nullptr;
+    try {
+        service = new calc_service(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            worker& w = service->workers[i];
+            w.thread = std::thread([service, &w] { service->run(w); });
+            if (pin) pin_to_cpu(w.thread, static_cast<unsigned>(i % hw));
+        }
+    } catch (const std::bad_alloc&) {
+        calc_service_destroy(service);
+        return nullptr;
+    } catch (const std::system_error&) {
+        calc_service_destroy(service);
+        return nullptr;
+    }
+    return service;
+}
+
+void calc_service_destroy(calc_service_t* service) {
+    if (!service) return;
+    service->stop.store(true, std::memory_order_release);
+    for (worker& w : service->workers) {
+        w.notify();
+        if (w.thread.joinable()) w.thread.join();
+    }
+    delete service;
+}
+
+calc_client_t* calc_client_create(calc_service_t* service, int ring_entries) {
+    unsigned i = service->next_worker.fetch_add(1, std::memory_order_relaxed);
+    worker* owner = &service->workers[i % service->workers.size()];
+    std::size_t entries = ring_entries > 0 ? static_cast<std::size_t>(ring_entries) : 1;
+    try {
+        calc_client* client = new calc_client(service, owner, entries);
+        std::lock_guard<std::mutex> guard(owner->clients_lock);
+        owner->clients.push_back(client);
+        return client;
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void calc_client_destroy(calc_client_t* client) {
+    if (!client) return;
+    {
+        std::lock_guard<std::mutex> guard(client->owner->clients_lock);
+        std::vector<calc_client*>& clients = client->owner->clients;
+        clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+    }
+    delete client;
+}
+
+int calc_client_submit(calc_client_t* client, const calc_sqe_t* sqes, int n) {
+    if (n <= 0) return 0;
+    std::size_t pushed = client->sq.push(sqes, static_cast<std::size_t>(n));
+    if (pushed > 0) client->owner->notify();
+    return static_cast<int>(pushed);
+}
+
+int calc_client_reap(calc_client_t* client, calc_cqe_t* out, int max) {
+    if (max <= 0) return 0;
+    return static_cast<int>(client->cq.pop(out, static_cast<std::size_t>(max)));
+}
+
+int calc_client_wait(calc_client_t* client, calc_cqe_t* out, int max, int min_complete) {
+    if (min_complete > max) min_complete = max;
+    int got = 0;
+    while (true) {
+        got += calc_client_reap(client, out + got, max - got);
+        if (got >= min_complete) return got;
+        // A full completion ring parks the worker until it is drained; the
+        // yield also lets the worker run when both share a core.
+        client->owner->notify();
+        std::this_thread::yield();
+    }
+}
+
+}
@@ -1,92 +1,257 @@
 #include "calculator.h"
+#include "heap_stats.h"
+
+#define HEAP_SIFT_STAT HEAP_STAT_ADD
+#include "heap_sift.h"
+#include <limits.h>
 #include <stdlib.h>
+#include <string.h>
+
+#define CALCULATOR_API_INLINE
+#include "calculator_inline.h"
 
-int add(int a, int b) {
-    return a + b;
+#define INT_HEAP_SWAP(heap, i, j) HEAP_ARRAY_SWAP(int, heap, i, j)
+HEAP_DEFINE_SIFT(heap, int*, HEAP_ARRAY_LESS, INT_HEAP_SWAP)
+
+static void* default_alloc(void* ctx, size_t bytes) {
+    (void)ctx;
+    return malloc(bytes);
 }
 
-int subtract(int a, int b) {
-    return a - b;
+static void* default_resize(void* ctx, void* ptr, size_t old_bytes, size_t new_bytes) {
+    (void)ctx;
+    (void)old_bytes;
+    return realloc(ptr, new_bytes);
 }
 
-int multiply(int a, int b) {
-    return a * b;
+static void default_release(void* ctx, void* ptr, size_t bytes) {
+    (void)ctx;
+    (void)bytes;
+    free(ptr);
 }
 
-int calculator_mod(int a, int b, int* error) {
-    if (b == 0) {
-        if (error) *error = 1;
-        return 0;
-    }
-    if (error) *error = 0;
-    return a % b;
+static const min_heap_allocator_t default_allocator = {default_alloc, default_resize, default_release, NULL};
+
+static const min_heap_allocator_t* heap_allocator(const min_heap_t* heap) {
+    return heap->allocator ? heap->allocator : &default_allocator;
 }
 
-int divide(int a, int b, int* error) {
-    if (b == 0) {
-        if (error) {
-            *error = 1;
+static int heap_set_capacity(min_heap_t* heap, int capacity) {
+    const min_heap_allocator_t* a = heap_allocator(heap);
+    if (capacity == 0) {
+        if (heap->capacity > 0) {
+            a->release(a->ctx, heap->data, (size_t)heap->capacity * sizeof(int));
         }
+        heap->data = NULL;
+        heap->capacity = 0;
         return 0;
     }
-    if (error) {
-        *error = 0;
+    int* data;
+    if (heap->capacity == 0) {
+        data = (int*)a->alloc(a->ctx, (size_t)capacity * sizeof(int));
+    } else {
+        data = (int*)a->resize(a->ctx, heap->data, (size_t)heap->capacity * sizeof(int),
+                               (size_t)capacity * sizeof(int));
+    }
+    if (!data) return -1;
+    HEAP_STAT_ADD(reallocs, 1);
+    heap->data = data;
+    heap->capacity = capacity;
+    return 0;
+}
+
+// Growth policy shared by every insert path: start at 10, then double. An
+// allocator with a hard cap (the VM arena's reservation) can refuse the
+// doubled size while `needed` still fits, so fall back to exactly `needed`.
+static int heap_grow(min_heap_t* heap, int needed) {
+    if (heap->capacity >= needed) return 0;
+    int new_capacity = heap->capacity == 0 ? 10 : heap->capacity;
+    while (new_capacity < needed) {
+        new_capacity = new_capacity > INT_MAX / 2 ? INT_MAX : new_capacity * 2;
     }
-    return a / b;
+    if (heap_set_capacity(heap, new_capacity) == 0) return 0;
+    return new_capacity > needed ? heap_set_capacity(heap, needed) : -1;
 }
 
-static void heap_sift_up(int* heap, int idx) {
-    while (idx > 0) {
-        int parent = (idx - 1) / 2;
-        if (heap[parent] <= heap[idx]) break;
-        int tmp = heap[parent];
-        heap[parent] = heap[idx];
-        heap[idx] = tmp;
-        idx = parent;
+static void heap_heapify(int* heap, int size) {
+    for (int idx = size / 2 - 1; idx >= 0; --idx) {
+        heap_sift_down(heap, size, idx);
     }
 }
 
-static void heap_sift_down(int* heap, int size, int idx) {
+// Removes the root of a non-empty heap of `size` elements. The hole left at the
+// root is walked down to a leaf along the smaller child (one comparison per
+// level) and the former last element is sifted up from there, which is cheaper
+// than a full heap_sift_down from the root. heap[size - 1] is free afterwards.
+static int heap_pop_root(int* heap, int size) {
+    int min = heap[0];
+    int last = heap[size - 1];
+    int n = size - 1;
+    int idx = 0;
     while (1) {
-        int left = idx * 2 + 1;
-        int right = idx * 2 + 2;
-        int smallest = idx;
-        if (left < size && heap[left] < heap[smallest]) smallest = left;
-        if (right < size && heap[right] < heap[smallest]) smallest = right;
-        if (smallest == idx) break;
-        int tmp = heap[smallest];
-        heap[smallest] = heap[idx];
-        heap[idx] = tmp;
-        idx = smallest;
+        int child = idx * 2 + 1;
+        if (child >= n) break;
+        HEAP_STAT_ADD(comparisons, child + 1 < n);
+        if (child + 1 < n && heap[child + 1] < heap[child]) child++;
+        heap[idx] = heap[child];
+        HEAP_STAT_ADD(sift_down_levels, 1);
+        idx = child;
     }
+    heap[idx] = last;
+    heap_sift_up(heap, idx);
+    return min;
 }
 
-void min_heap_insert(int** heap, int* size, int* capacity, int value) {
-    if (*capacity == 0) {
-        *capacity = 10;
-        *heap = (int*)malloc(*capacity * sizeof(int));
-    } else if (*size >= *capacity) {
-        *capacity *= 2;
-        *heap = (int*)realloc(*heap, *capacity * sizeof(int));
+static int heap_pop_n(int* heap, int* size, int* out, int k) {
+    int n = *size;
+    int count = k < n ? k : n;
+    if (count < 0) count = 0;
+    for (int i = 0; i < count; ++i) {
+        out[i] = heap_pop_root(heap, n - i);
     }
-    (*heap)[*size] = value;
-    (*size)++;
-    heap_sift_up(*heap, *size - 1);
+    *size = n - count;
+    return count;
+}
+
+int min_heap_init(min_heap_t* heap, int capacity_hint, const min_heap_allocator_t* allocator) {
+    heap->data = NULL;
+    heap->size = 0;
+    heap->capacity = 0;
+    heap->allocator = allocator;
+    return capacity_hint > 0 ? heap_set_capacity(heap, capacity_hint) : 0;
+}
+
+int min_heap_reserve(min_heap_t* heap, int capacity) {
+    if (capacity <= heap->capacity) return 0;
+    return heap_set_capacity(heap, capacity);
+}
+
+int min_heap_shrink_to_fit(min_heap_t* heap) {
+    if (heap->size == heap->capacity) return 0;
+    return heap_set_capacity(heap, heap->size);
+}
+
+int min_heap_push(min_heap_t* heap, int value) {
+    HEAP_STAT_ADD(pushes, 1);
+    if (heap_grow(heap, heap->size + 1) != 0) return -1;
+    heap->data[heap->size] = value;
+    heap_sift_up(heap->data, heap->size);
+    heap->size++;
+    return 0;
+}
+
+int min_heap_push_many(min_heap_t* heap, const int* values, int n) {
+    if (n <= 0) return 0;
+    HEAP_STAT_ADD(pushes, (unsigned)n);
+    if (heap_grow(heap, heap->size + n) != 0) return -1;
+    int* data = heap->data;
+    int old_size = heap->size;
+    int size = old_size + n;
+    memcpy(data + old_size, values, (size_t)n * sizeof(int));
+    if (n >= old_size) {
+        // Re-heapifying is O(size + n) and beats n sift-ups once the batch dominates.
+        heap_heapify(data, size);
+    } else {
+        for (int i = old_size; i < size; ++i) {
+            heap_sift_up(data, i);
+        }
+    }
+    heap->size = size;
+    return 0;
+}
+
+int min_heap_assign(min_heap_t* heap, const int* values, int n) {
+    heap->size = 0;
+    if (n <= 0) return 0;
+    if (heap->capacity < n) {
+        // Previous contents are discarded, so skip the resize copy.
+        heap_set_capacity(heap, 0);
+        if (heap_set_capacity(heap, n) != 0) return -1;
+    }
+    memcpy(heap->data, values, (size_t)n * sizeof(int));
+    heap_heapify(heap->data, n);
+    heap->size = n;
+    return 0;
+}
+
+int min_heap_pop(min_heap_t* heap, int* out) {
+    if (heap->size == 0) return -1;
+    int min = heap_pop_root(heap->data, heap->size);
+    heap->size--;
+    if (out) *out = min;
+    return 0;
+}
+
+int min_heap_pop_n(min_heap_t* heap, int* out, int k) {
+    return heap_pop_n(heap->data, &heap->size, out, k);
+}
+
+int min_heap_peek(const min_heap_t* heap, int* out) {
+    if (heap->size == 0) return -1;
+    if (out) *out = heap->data[0];
+    return 0;
+}
+
+void min_heap_destroy(min_heap_t* heap) {
+    heap_set_capacity(heap, 0);
+    heap->size = 0;
+}
+
+// Legacy pointer-triple API: thin wrappers over min_heap_t with the default allocator.
+
+#define LEGACY_HEAP_VIEW(heap, size, capacity) {*(heap), *(size), *(capacity), NULL}
+
+static void legacy_store(const min_heap_t* view, int** heap, int* size, int* capacity) {
+    *heap = view->data;
+    *size = view->size;
+    *capacity = view->capacity;
+}
+
+void min_heap_insert(int** heap, int* size, int* capacity, int value) {
+    min_heap_t view = LEGACY_HEAP_VIEW(heap, size, capacity);
+    min_heap_push(&view, value);
+    legacy_store(&view, heap, size, capacity);
+}
+
+void min_heap_build(int** heap, int* size, int* capacity, const int* values, int n) {
+    min_heap_t view = LEGACY_HEAP_VIEW(heap, size, capacity);
+    min_heap_assign(&view, values, n);
+    legacy_store(&view, heap, size, capacity);
+}
+
+void min_heap_insert_many(int** heap, int* size, int* capacity, const int* values, int n) {
+    min_heap_t view = LEGACY_HEAP_VIEW(heap, size, capacity);
+    min_heap_push_many(&view, values, n);
+    legacy_store(&view, heap, size, capacity);
 }
 
 int min_heap_delete_min(int** heap, int* size) {
     if (*size == 0) {
         return -1; // empty queue
     }
-    int min = (*heap)[0];
-    (*heap)[0] = (*heap)[*size - 1];
+    int min = heap_pop_root(*heap, *size);
     (*size)--;
-    if (*size > 0) {
-        heap_sift_down(*heap, *size, 0);
-    }
     return min;
 }
 
+int min_heap_delete_min_n(int** heap, int* size, int* out, int k) {
+    return heap_pop_n(*heap, size, out, k);
+}
+
+void min_heap_sort(int* heap, int size) {
+    // Each popped minimum lands in the slot the heap just gave up, leaving the
+    // array in descending order; reversing it yields ascending order, which is
+    // itself a valid min-heap.
+    for (int end = size; end > 1; --end) {
+        heap[end - 1] = heap_pop_root(heap, end);
+    }
+    for (int lo = 0, hi = size - 1; lo < hi; ++lo, --hi) {
+        int tmp = heap[lo];
+        heap[lo] = heap[hi];
+        heap[hi] = tmp;
+    }
+}
+
 int min_heap_peek_min(int* heap, int size) {
     if (size == 0) {
         return -1;
@@ -102,4 +267,3 @@ void destroy_queue(int** heap, int* size, int* capacity) {
     if (size) *size = 0;
     if (capacity) *capacity = 0;
 }
-
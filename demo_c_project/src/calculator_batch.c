@@ -0,0 +1,172 @@
+#include "calculator.h"
+#include "cpu_features.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BATCH_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define BATCH_NEON 1
+#include <arm_neon.h>
+#endif
+
+/* Array kernels wrap on overflow (two's complement), so the arithmetic is done
+ * on unsigned values. out may alias a or b exactly; every path loads a block
+ * before storing it. */
+#define SCALAR_ADD(x, y) ((int)((unsigned)(x) + (unsigned)(y)))
+#define SCALAR_SUB(x, y) ((int)((unsigned)(x) - (unsigned)(y)))
+#define SCALAR_MUL(x, y) ((int)((unsigned)(x) * (unsigned)(y)))
+
+#define DEFINE_SCALAR_KERNELS(name, SOP)                                          \
+    static void name##_vv_scalar(const int* a, const int* b, int* out, size_t n) { \
+        for (size_t i = 0; i < n; ++i) out[i] = SOP(a[i], b[i]);                  \
+    }                                                                             \
+    static void name##_vs_scalar(const int* a, int b, int* out, size_t n) {       \
+        for (size_t i = 0; i < n; ++i) out[i] = SOP(a[i], b);                     \
+    }
+
+DEFINE_SCALAR_KERNELS(add, SCALAR_ADD)
+DEFINE_SCALAR_KERNELS(sub, SCALAR_SUB)
+DEFINE_SCALAR_KERNELS(mul, SCALAR_MUL)
+
+#ifdef BATCH_X86
+#define AVX2_ATTR __attribute__((target("avx2")))
+#define AVX512_ATTR __attribute__((target("avx512f")))
+
+#define DEFINE_AVX2_KERNELS(name, VOP, SOP)                                               \
+    AVX2_ATTR static void name##_vv_avx2(const int* a, const int* b, int* out, size_t n) { \
+        size_t i = 0;                                                                     \
+        for (; i + 8 <= n; i += 8) {                                                      \
+            __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));                      \
+            __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));                      \
+            _mm256_storeu_si256((__m256i*)(out + i), VOP(x, y));                          \
+        }                                                                                 \
+        for (; i < n; ++i) out[i] = SOP(a[i], b[i]);                                      \
+    }                                                                                     \
+    AVX2_ATTR static void name##_vs_avx2(const int* a, int b, int* out, size_t n) {       \
+        __m256i y = _mm256_set1_epi32(b);                                                 \
+        size_t i = 0;                                                                     \
+        for (; i + 8 <= n; i += 8) {                                                      \
+            __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));                      \
+            _mm256_storeu_si256((__m256i*)(out + i), VOP(x, y));                          \
+        }                                                                                 \
+        for (; i < n; ++i) out[i] = SOP(a[i], b);                                         \
+    }
+
+/* AVX-512 handles the tail with a masked load/store instead of a scalar loop. */
+#define DEFINE_AVX512_KERNELS(name, VOP)                                                      \
+    AVX512_ATTR static void name##_vv_avx512(const int* a, const int* b, int* out, size_t n) { \
+        size_t i = 0;                                                                         \
+        for (; i + 16 <= n; i += 16) {                                                        \
+            __m512i x = _mm512_loadu_si512((const void*)(a + i));                             \
+            __m512i y = _mm512_loadu_si512((const void*)(b + i));                             \
+            _mm512_storeu_si512((void*)(out + i), VOP(x, y));                                 \
+        }                                                                                     \
+        if (i < n) {                                                                          \
+            __mmask16 m = (__mmask16)((1u << (n - i)) - 1);                                   \
+            __m512i x = _mm512_maskz_loadu_epi32(m, a + i);                                   \
+            __m512i y = _mm512_maskz_loadu_epi32(m, b + i);                                   \
+            _mm512_mask_storeu_epi32(out + i, m, VOP(x, y));                                  \
+        }                                                                                     \
+    }                                                                                         \
+    AVX512_ATTR static void name##_vs_avx512(const int* a, int b, int* out, size_t n) {       \
+        __m512i y = _mm512_set1_epi32(b);                                                     \
+        size_t i = 0;                                                                         \
+        for (; i + 16 <= n; i += 16) {                                                        \
+            __m512i x = _mm512_loadu_si512((const void*)(a + i));                             \
+            _mm512_storeu_si512((void*)(out + i), VOP(x, y));                                 \
+        }                                                                                     \
+        if (i < n) {                                                                          \
+            __mmask16 m = (__mmask16)((1u << (n - i)) - 1);                                   \
+            __m512i x = _mm512_maskz_loadu_epi32(m, a + i);                                   \
+            _mm512_mask_storeu_epi32(out + i, m, VOP(x, y));                                  \
+        }                                                                                     \
+    }
+
+DEFINE_AVX2_KERNELS(add, _mm256_add_epi32, SCALAR_ADD)
+DEFINE_AVX2_KERNELS(sub, _mm256_sub_epi32, SCALAR_SUB)
+DEFINE_AVX2_KERNELS(mul, _mm256_mullo_epi32, SCALAR_MUL)
+DEFINE_AVX512_KERNELS(add, _mm512_add_epi32)
+DEFINE_AVX512_KERNELS(sub, _mm512_sub_epi32)
+DEFINE_AVX512_KERNELS(mul, _mm512_mullo_epi32)
+#endif
+
+#ifdef BATCH_NEON
+#define DEFINE_NEON_KERNELS(name, VOP, SOP)                                        \
+    static void name##_vv_neon(const int* a, const int* b, int* out, size_t n) {   \
+        size_t i = 0;                                                              \
+        for (; i + 4 <= n; i += 4) {                                               \
+            vst1q_s32(out + i, VOP(vld1q_s32(a + i), vld1q_s32(b + i)));           \
+        }                                                                          \
+        for (; i < n; ++i) out[i] = SOP(a[i], b[i]);                               \
+    }                                                                              \
+    static void name##_vs_neon(const int* a, int b, int* out, size_t n) {          \
+        int32x4_t y = vdupq_n_s32(b);                                              \
+        size_t i = 0;                                                              \
+        for (; i + 4 <= n; i += 4) {                                               \
+            vst1q_s32(out + i, VOP(vld1q_s32(a + i), y));                          \
+        }                                                                          \
+        for (; i < n; ++i) out[i] = SOP(a[i], b);                                  \
+    }
+
+DEFINE_NEON_KERNELS(add, vaddq_s32, SCALAR_ADD)
+DEFINE_NEON_KERNELS(sub, vsubq_s32, SCALAR_SUB)
+DEFINE_NEON_KERNELS(mul, vmulq_s32, SCALAR_MUL)
+#endif
+
+/* `features` is read once per call by the caller, as in heap_kernels.c. */
+#if defined(BATCH_X86)
+#define SELECT_KERNEL(features, name, shape)                             \
+    ((features) & CPU_FEATURE_AVX512F ? name##_##shape##_avx512          \
+     : (features) & CPU_FEATURE_AVX2  ? name##_##shape##_avx2            \
+                                      : name##_##shape##_scalar)
+#elif defined(BATCH_NEON)
+#define SELECT_KERNEL(features, name, shape) \
+    ((features) & CPU_FEATURE_NEON ? name##_##shape##_neon : name##_##shape##_scalar)
+#else
+#define SELECT_KERNEL(features, name, shape) ((void)(features), name##_##shape##_scalar)
+#endif
+
+void add_n(const int* a, const int* b, int* out, size_t n) {
+    unsigned features = cpu_features();
+    SELECT_KERNEL(features, add, vv)(a, b, out, n);
+}
+
+void subtract_n(const int* a, const int* b, int* out, size_t n) {
+    unsigned features = cpu_features();
+    SELECT_KERNEL(features, sub, vv)(a, b, out, n);
+}
+
+void multiply_n(const int* a, const int* b, int* out, size_t n) {
+    unsigned features = cpu_features();
+    SELECT_KERNEL(features, mul, vv)(a, b, out, n);
+}
+
+void add_inplace_n(int* a, const int* b, size_t n) {
+    unsigned features = cpu_features();
+    SELECT_KERNEL(features, add, vv)(a, b, a, n);
+}
+
+void subtract_inplace_n(int* a, const int* b, size_t n) {
+    unsigned features = cpu_features();
+    SELECT_KERNEL(features, sub, vv)(a, b, a, n);
+}
+
+void multiply_inplace_n(int* a, const int* b, size_t n) {
+    unsigned features = cpu_features();
+    SELECT_KERNEL(features, mul, vv)(a, b, a, n);
+}
+
+void add_scalar_n(const int* a, int b, int* out, size_t n) {
+    unsigned features = cpu_features();
+    SELECT_KERNEL(features, add, vs)(a, b, out, n);
+}
+
+void subtract_scalar_n(const int* a, int b, int* out, size_t n) {
+    unsigned features = cpu_features();
+    SELECT_KERNEL(features, sub, vs)(a, b, out, n);
+}
+
+void multiply_scalar_n(const int* a, int b, int* out, size_t n) {
+    unsigned features = cpu_features();
+    SELECT_KERNEL(features, mul, vs)(a, b, out, n);
+}
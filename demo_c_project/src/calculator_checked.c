@@ -0,0 +1,147 @@
+#include "calculator.h"
+
+#include <limits.h>
+#include <stdint.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CALC_ADD_OVERFLOW(a, b, r) __builtin_add_overflow(a, b, r)
+#define CALC_SUB_OVERFLOW(a, b, r) __builtin_sub_overflow(a, b, r)
+#define CALC_MUL_OVERFLOW(a, b, r) __builtin_mul_overflow(a, b, r)
+#else
+static int calc_wide_overflow(int64_t wide, int* r) {
+    *r = (int)(uint32_t)wide;
+    return wide < INT_MIN || wide > INT_MAX;
+}
+#define CALC_ADD_OVERFLOW(a, b, r) calc_wide_overflow((int64_t)(a) + (b), r)
+#define CALC_SUB_OVERFLOW(a, b, r) calc_wide_overflow((int64_t)(a) - (b), r)
+#define CALC_MUL_OVERFLOW(a, b, r) calc_wide_overflow((int64_t)(a) * (b), r)
+#endif
+
+/* Overflow bit tests used by the array kernels. They are plain integer
+ * expressions without branches so the loops auto-vectorize. */
+#define ADD_OVERFLOWS(a, b, r) ((((a) ^ (r)) & ((b) ^ (r))) < 0)
+#define SUB_OVERFLOWS(a, b, r) ((((a) ^ (b)) & ((a) ^ (r))) < 0)
+/* On add/sub overflow the true result lies beyond the limit on a's side. */
+#define SATURATE_TOWARD(a) (((a) >> 31) ^ INT_MAX)
+
+static void set_flag(int* flag, int value) {
+    if (flag) *flag = value;
+}
+
+int add_checked(int a, int b, int* overflow) {
+    int r;
+    set_flag(overflow, CALC_ADD_OVERFLOW(a, b, &r));
+    return r;
+}
+
+int subtract_checked(int a, int b, int* overflow) {
+    int r;
+    set_flag(overflow, CALC_SUB_OVERFLOW(a, b, &r));
+    return r;
+}
+
+int multiply_checked(int a, int b, int* overflow) {
+    int r;
+    set_flag(overflow, CALC_MUL_OVERFLOW(a, b, &r));
+    return r;
+}
+
+int divide_checked(int a, int b, int* error, int* overflow) {
+    set_flag(overflow, 0);
+    if (b == -1 && a == INT_MIN) {
+        set_flag(error, 0);
+        set_flag(overflow, 1);
+        return INT_MIN;
+    }
+    return divide(a, b, error);
+}
+
+int add_sat(int a, int b) {
+    int r;
+    return CALC_ADD_OVERFLOW(a, b, &r) ? SATURATE_TOWARD(a) : r;
+}
+
+int subtract_sat(int a, int b) {
+    int r;
+    return CALC_SUB_OVERFLOW(a, b, &r) ? SATURATE_TOWARD(a) : r;
+}
+
+int multiply_sat(int a, int b) {
+    int r;
+    if (!CALC_MUL_OVERFLOW(a, b, &r)) return r;
+    return ((a < 0) != (b < 0)) ? INT_MIN : INT_MAX;
+}
+
+int divide_sat(int a, int b, int* error) {
+    if (b == -1 && a == INT_MIN) {
+        set_flag(error, 0);
+        return INT_MAX;
+    }
+    return divide(a, b, error);
+}
+
+int add_checked_n(const int* a, const int* b, int* out, size_t n) {
+    int overflow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        int r = (int)((uint32_t)a[i] + (uint32_t)b[i]);
+        overflow |= ADD_OVERFLOWS(a[i], b[i], r);
+        out[i] = r;
+    }
+    return overflow;
+}
+
+int subtract_checked_n(const int* a, const int* b, int* out, size_t n) {
+    int overflow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        int r = (int)((uint32_t)a[i] - (uint32_t)b[i]);
+        overflow |= SUB_OVERFLOWS(a[i], b[i], r);
+        out[i] = r;
+    }
+    return overflow;
+}
+
+int multiply_checked_n(const int* a, const int* b, int* out, size_t n) {
+    int overflow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        int64_t wide = (int64_t)a[i] * b[i];
+        int r = (int)(uint32_t)wide;
+        overflow |= (int64_t)r != wide;
+        out[i] = r;
+    }
+    return overflow;
+}
+
+int add_sat_n(const int* a, const int* b, int* out, size_t n) {
+    int saturated = 0;
+    for (size_t i = 0; i < n; ++i) {
+        int x = a[i];
+        int r = (int)((uint32_t)x + (uint32_t)b[i]);
+        int ovf = ADD_OVERFLOWS(x, b[i], r);
+        saturated |= ovf;
+        out[i] = ovf ? SATURATE_TOWARD(x) : r;
+    }
+    return saturated;
+}
+
+int subtract_sat_n(const int* a, const int* b, int* out, size_t n) {
+    int saturated = 0;
+    for (size_t i = 0; i < n; ++i) {
+        int x = a[i];
+        int r = (int)((uint32_t)x - (uint32_t)b[i]);
+        int ovf = SUB_OVERFLOWS(x, b[i], r);
+        saturated |= ovf;
+        out[i] = ovf ? SATURATE_TOWARD(x) : r;
+    }
+    return saturated;
+}
+
+int multiply_sat_n(const int* a, const int* b, int* out, size_t n) {
+    int saturated = 0;
+    for (size_t i = 0; i < n; ++i) {
+        int64_t wide = (int64_t)a[i] * b[i];
+        int64_t clamped = wide > INT_MAX ? INT_MAX : wide < INT_MIN ? INT_MIN : wide;
+        saturated |= clamped != wide;
+        out[i] = (int)clamped;
+    }
+    return saturated;
+}
@@ -0,0 +1,234 @@
+#include "calculator.h"
+#include "cpu_features.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DIVIDE_X86 1
+#include <immintrin.h>
+#endif
+
+enum {
+    DIVISOR_ZERO = 0,
+    DIVISOR_ONE = 1,
+    DIVISOR_MINUS_ONE = 2,
+    DIVISOR_MAGIC = 3,
+};
+
+/* Signed magic number for 2 <= |d| <= 2^31 (Hacker's Delight, 10-1). */
+static void compute_magic(int d, int* magic, int* shift) {
+    const uint32_t two31 = 0x80000000u;
+    uint32_t ad = d < 0 ? 0u - (uint32_t)d : (uint32_t)d;
+    uint32_t t = two31 + ((uint32_t)d >> 31);
+    uint32_t anc = t - 1 - t % ad;
+    int p = 31;
+    uint32_t q1 = two31 / anc, r1 = two31 - q1 * anc;
+    uint32_t q2 = two31 / ad, r2 = two31 - q2 * ad;
+    uint32_t delta;
+    do {
+        p++;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= anc) {
+            q1++;
+            r1 -= anc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= ad) {
+            q2++;
+            r2 -= ad;
+        }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+    uint32_t m = q2 + 1;
+    *magic = (int)(d < 0 ? 0u - m : m);
+    *shift = p - 32;
+}
+
+int calc_divisor_prepare(calc_divisor_t* d, int divisor) {
+    memset(d, 0, sizeof(*d));
+    d->divisor = divisor;
+    if (divisor == 0) {
+        d->kind = DIVISOR_ZERO;
+        return 1;
+    }
+    if (divisor == 1) {
+        d->kind = DIVISOR_ONE;
+    } else if (divisor == -1) {
+        d->kind = DIVISOR_MINUS_ONE;
+    } else {
+        d->kind = DIVISOR_MAGIC;
+        compute_magic(divisor, &d->magic, &d->shift);
+        // The multiply-high under-/over-shoots by n when the magic's sign
+        // disagrees with the divisor's; fold that correction into a factor.
+        d->correction = (divisor > 0 && d->magic < 0) ? 1 : (divisor < 0 && d->magic > 0) ? -1 : 0;
+    }
+    return 0;
+}
+
+static inline int magic_quotient(int n, int magic, int shift, int correction) {
+    int q = (int)(((int64_t)magic * n) >> 32);
+    q = (int)((uint32_t)q + (uint32_t)n * (uint32_t)correction);
+    q >>= shift;
+    return q + (int)((uint32_t)q >> 31);
+}
+
+int calc_divisor_divide(const calc_divisor_t* d, int n) {
+    switch (d->kind) {
+    case DIVISOR_ONE:
+        return n;
+    case DIVISOR_MINUS_ONE:
+        return (int)(0u - (uint32_t)n);
+    case DIVISOR_MAGIC:
+        return magic_quotient(n, d->magic, d->shift, d->correction);
+    default:
+        return 0;
+    }
+}
+
+static void magic_divide_scalar(const int* a, const calc_divisor_t* d, int* out, size_t n) {
+    const int magic = d->magic;
+    const int shift = d->shift;
+    const int correction = d->correction;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = magic_quotient(a[i], magic, shift, correction);
+    }
+}
+
+#ifdef DIVIDE_X86
+__attribute__((target("avx2"))) static void magic_divide_avx2(const int* a, const calc_divisor_t* d, int* out,
+                                                              size_t n) {
+    const __m256i magic = _mm256_set1_epi32(d->magic);
+    const __m256i correction = _mm256_set1_epi32(d->correction);
+    const __m128i shift = _mm_cvtsi32_si128(d->shift);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        // 32x32->64 signed multiply on even and odd lanes, keep the high halves.
+        __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(x, magic), 32);
+        __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(x, 32), magic);
+        __m256i q = _mm256_blend_epi32(even, odd, 0xAA);
+        q = _mm256_add_epi32(q, _mm256_mullo_epi32(x, correction));
+        q = _mm256_sra_epi32(q, shift);
+        q = _mm256_add_epi32(q, _mm256_srli_epi32(q, 31));
+        _mm256_storeu_si256((__m256i*)(out + i), q);
+    }
+    magic_divide_scalar(a + i, d, out + i, n - i);
+}
+#endif
+
+int divide_prepared_n(const int* a, const calc_divisor_t* d, int* out, size_t n) {
+    switch (d->kind) {
+    case DIVISOR_ZERO:
+        memset(out, 0, n * sizeof(int));
+        return 1;
+    case DIVISOR_ONE:
+        if (out != a) memmove(out, a, n * sizeof(int));
+        return 0;
+    case DIVISOR_MINUS_ONE:
+        for (size_t i = 0; i < n; ++i) out[i] = (int)(0u - (uint32_t)a[i]);
+        return 0;
+    default:
+        break;
+    }
+#ifdef DIVIDE_X86
+    if (cpu_features() & CPU_FEATURE_AVX2) {
+        magic_divide_avx2(a, d, out, n);
+        return 0;
+    }
+#endif
+    magic_divide_scalar(a, d, out, n);
+    return 0;
+}
+
+int mod_prepared_n(const int* a, const calc_divisor_t* d, int* out, size_t n) {
+    if (d->kind == DIVISOR_ZERO) {
+        memset(out, 0, n * sizeof(int));
+        return 1;
+    }
+    // Quotients go to a stack block rather than `out`, so out may alias a.
+    int q[256];
+    const uint32_t divisor = (uint32_t)d->divisor;
+    for (size_t base = 0; base < n; base += 256) {
+        size_t m = n - base < 256 ? n - base : 256;
+        divide_prepared_n(a + base, d, q, m);
+        for (size_t i = 0; i < m; ++i) {
+            out[base + i] = (int)((uint32_t)a[base + i] - (uint32_t)q[i] * divisor);
+        }
+    }
+    return 0;
+}
+
+int divide_scalar_n(const int* a, int b, int* out, size_t n) {
+    calc_divisor_t d;
+    calc_divisor_prepare(&d, b);
+    return divide_prepared_n(a, &d, out, n);
+}
+
+int mod_scalar_n(const int* a, int b, int* out, size_t n) {
+    calc_divisor_t d;
+    calc_divisor_prepare(&d, b);
+    return mod_prepared_n(a, &d, out, n);
+}
+
+/* Per-element divisors cannot share a reciprocal, so these use hardware
+ * division but replace zero divisors by 1 up front and patch the result, which
+ * keeps the loop free of early exits. One loop serves the wrapping, checked
+ * and saturating forms: INT_MIN / -1 is flagged through *overflow (may be
+ * NULL) and, when `saturate` is set, clamped to INT_MAX. */
+static int divide_or_mod_n(const int* a, const int* b, int* out, unsigned char* error_bits, size_t n, int want_mod,
+                           int saturate, int* overflow) {
+    int any_error = 0;
+    int any_overflow = 0;
+    if (error_bits) memset(error_bits, 0, (n + 7) / 8);
+    for (size_t i = 0; i < n; ++i) {
+        int x = a[i];
+        int d = b[i];
+        int zero = d == 0;
+        // INT_MIN / -1 overflows; route it through the wrapping negation below.
+        int minus_one = d == -1;
+        int ovf = minus_one & (x == INT_MIN);
+        int safe = (zero | minus_one) ? 1 : d;
+        int q = minus_one ? (int)(0u - (uint32_t)x) : x / safe;
+        int r = minus_one ? 0 : x % safe;
+        if (saturate && ovf) q = INT_MAX;
+        out[i] = zero ? 0 : (want_mod ? r : q);
+        any_error |= zero;
+        any_overflow |= ovf;
+        if (error_bits) error_bits[i / 8] |= (unsigned char)(zero << (i % 8));
+    }
+    if (overflow) *overflow = any_overflow;
+    return any_error;
+}
+
+int divide_n(const int* a, const int* b, int* out, unsigned char* error_bits, size_t n) {
+    return divide_or_mod_n(a, b, out, error_bits, n, 0, 0, NULL);
+}
+
+int mod_n(const int* a, const int* b, int* out, unsigned char* error_bits, size_t n) {
+    return divide_or_mod_n(a, b, out, error_bits, n, 1, 0, NULL);
+}
+
+int divide_checked_n(const int* a, const int* b, int* out, unsigned char* error_bits, int* error, size_t n) {
+    int overflow;
+    int any_error = divide_or_mod_n(a, b, out, error_bits, n, 0, 0, &overflow);
+    if (error) *error = any_error;
+    return overflow;
+}
+
+int mod_checked_n(const int* a, const int* b, int* out, unsigned char* error_bits, int* error, size_t n) {
+    int overflow;
+    int any_error = divide_or_mod_n(a, b, out, error_bits, n, 1, 0, &overflow);
+    if (error) *error = any_error;
+    return overflow;
+}
+
+int divide_sat_n(const int* a, const int* b, int* out, unsigned char* error_bits, int* error, size_t n) {
+    int saturated;
+    int any_error = divide_or_mod_n(a, b, out, error_bits, n, 0, 1, &saturated);
+    if (error) *error = any_error;
+    return saturated;
+}
@@ -0,0 +1,60 @@
+#include "cpu_features.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* detect() result with CPU_DETECTED_VALID set, published with one atomic
+ * word so threads racing on the first call never see a half-initialised
+ * value. detect() is idempotent, so concurrent first calls may each run it
+ * and store the same value. */
+#define CPU_DETECTED_VALID 0x80000000u
+static unsigned g_detected;
+/* Per thread, so tests forcing a dispatch path can run concurrently. */
+#if defined(_MSC_VER)
+static __declspec(thread) unsigned g_mask = ~0u;
+#else
+static __thread unsigned g_mask = ~0u;
+#endif
+
+static unsigned detect(void) {
+    unsigned features = 0;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1")) features |= CPU_FEATURE_SSE41;
+    if (__builtin_cpu_supports("avx2")) features |= CPU_FEATURE_AVX2;
+    if (__builtin_cpu_supports("avx512f")) features |= CPU_FEATURE_AVX512F;
+#elif defined(__aarch64__)
+    features |= CPU_FEATURE_NEON;
+#endif
+    return features;
+}
+
+static unsigned load_detected(void) {
+#if defined(_MSC_VER)
+    return (unsigned)_InterlockedOr((volatile long*)&g_detected, 0);
+#else
+    return __atomic_load_n(&g_detected, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static void store_detected(unsigned value) {
+#if defined(_MSC_VER)
+    _InterlockedExchange((volatile long*)&g_detected, (long)value);
+#else
+    __atomic_store_n(&g_detected, value, __ATOMIC_RELEASE);
+#endif
+}
+
+unsigned cpu_features(void) {
+    unsigned detected = load_detected();
+    if (!(detected & CPU_DETECTED_VALID)) {
+        detected = detect() | CPU_DETECTED_VALID;
+        store_detected(detected);
+    }
+    return detected & g_mask & ~CPU_DETECTED_VALID;
+}
+
+void cpu_features_set_mask(unsigned mask) {
+    g_mask = mask;
+}
@@ -0,0 +1,104 @@
+#include "dary_heap.h"
+#include "dary_heap.hpp"
+#include "heap_kernels.h"
+
+#include <cstdlib>
+
+namespace {
+
+template <unsigned D>
+using int_heap = dary_heap<int, D>;
+
+template <unsigned D>
+void insert(int** heap, int* size, int* capacity, int value) {
+    if (*capacity == 0) {
+        *capacity = 10;
+        *heap = static_cast<int*>(std::malloc(*capacity * sizeof(int)));
+    } else if (*size >= *capacity) {
+        *capacity *= 2;
+        *heap = static_cast<int*>(std::realloc(*heap, *capacity * sizeof(int)));
+    }
+    (*heap)[*size] = value;
+    (*size)++;
+    int_heap<D>::sift_up(*heap, *size - 1, std::less<int>());
+}
+
+template <unsigned D>
+void sift_down(int* heap, int size, int idx);
+
+template <>
+void sift_down<4>(int* heap, int size, int idx) {
+    heap_sift_down_d4(heap, size, idx);
+}
+
+template <>
+void sift_down<8>(int* heap, int size, int idx) {
+    heap_sift_down_d8(heap, size, idx);
+}
+
+template <unsigned D>
+int pop_root(int* heap, int size) {
+    int min = heap[0];
+    if (size > 1) {
+        heap[0] = heap[size - 1];
+        sift_down<D>(heap, size - 1, 0);
+    }
+    return min;
+}
+
+template <unsigned D>
+int delete_min(int** heap, int* size) {
+    if (*size == 0) {
+        return -1;
+    }
+    int min = pop_root<D>(*heap, *size);
+    (*size)--;
+    return min;
+}
+
+template <unsigned D>
+int delete_min_n(int** heap, int* size, int* out, int k) {
+    int* data = *heap;
+    int n = *size;
+    int count = k < n ? k : n;
+    if (count < 0) count = 0;
+    for (int i = 0; i < count; ++i) {
+        out[i] = pop_root<D>(data, n - i);
+    }
+    *size = n - count;
+    return count;
+}
+
+int peek_min(int* heap, int size) {
+    if (size == 0) {
+        return -1;
+    }
+    return heap[0];
+}
+
+void destroy(int** heap, int* size, int* capacity) {
+    if (heap && *heap) {
+        std::free(*heap);
+        *heap = nullptr;
+    }
+    if (size) *size = 0;
+    if (capacity) *capacity = 0;
+}
+
+}  // namespace
+
+extern "C" {
+
+void dary4_heap_insert(int** heap, int* size, int* capacity, int value) { insert<4>(heap, size, capacity, value); }
+int dary4_heap_delete_min(int** heap, int* size) { return delete_min<4>(heap, size); }
+int dary4_heap_delete_min_n(int** heap, int* size, int* out, int k) { return delete_min_n<4>(heap, size, out, k); }
+int dary4_heap_peek_min(int* heap, int size) { return peek_min(heap, size); }
+void dary4_destroy_queue(int** heap, int* size, int* capacity) { destroy(heap, size, capacity); }
+
+void dary8_heap_insert(int** heap, int* size, int* capacity, int value) { insert<8>(heap, size, capacity, value); }
+int dary8_heap_delete_min(int** heap, int* size) { return delete_min<8>(heap, size); }
+int dary8_heap_delete_min_n(int** heap, int* size, int* out, int k) { return delete_min_n<8>(heap, size, out, k); }
+int dary8_heap_peek_min(int* heap, int size) { return peek_min(heap, size); }
+void dary8_destroy_queue(int** heap, int* size, int* capacity) { destroy(heap, size, capacity); }
+
+}
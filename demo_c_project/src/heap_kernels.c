@@ -0,0 +1,148 @@
+#include "heap_kernels.h"
+#include "cpu_features.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HEAP_KERNELS_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define HEAP_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+static inline int scalar_min_index(const int* v, int count) {
+    int best = 0;
+    for (int i = 1; i < count; ++i) {
+        if (v[i] < v[best]) best = i;
+    }
+    return best;
+}
+
+static inline int scalar_min_index4(const int* v) {
+    return scalar_min_index(v, 4);
+}
+
+static inline int scalar_min_index8(const int* v) {
+    return scalar_min_index(v, 8);
+}
+
+#ifdef HEAP_KERNELS_X86
+__attribute__((target("sse4.1"))) static inline __m128i hmin_epi32_sse41(__m128i v) {
+    v = _mm_min_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_min_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+__attribute__((target("sse4.1"))) static inline int sse41_min_index4(const int* v) {
+    __m128i x = _mm_loadu_si128((const __m128i*)v);
+    __m128i eq = _mm_cmpeq_epi32(x, hmin_epi32_sse41(x));
+    return __builtin_ctz((unsigned)_mm_movemask_ps(_mm_castsi128_ps(eq)));
+}
+
+__attribute__((target("sse4.1"))) static inline int sse41_min_index8(const int* v) {
+    __m128i lo = _mm_loadu_si128((const __m128i*)v);
+    __m128i hi = _mm_loadu_si128((const __m128i*)(v + 4));
+    __m128i m = hmin_epi32_sse41(_mm_min_epi32(lo, hi));
+    unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(lo, m)));
+    mask |= (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(hi, m))) << 4;
+    return __builtin_ctz(mask);
+}
+
+__attribute__((target("avx2"))) static inline int avx2_min_index8(const int* v) {
+    __m256i x = _mm256_loadu_si256((const __m256i*)v);
+    __m128i m = _mm_min_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m256i eq = _mm256_cmpeq_epi32(x, _mm256_broadcastd_epi32(m));
+    return __builtin_ctz((unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+}
+#endif
+
+#ifdef HEAP_KERNELS_NEON
+static inline int neon_min_index4(const int* v) {
+    static const uint32_t bits[4] = {1, 2, 4, 8};
+    int32x4_t x = vld1q_s32(v);
+    uint32x4_t eq = vceqq_s32(x, vdupq_n_s32(vminvq_s32(x)));
+    return __builtin_ctz(vaddvq_u32(vandq_u32(eq, vld1q_u32(bits))));
+}
+
+static inline int neon_min_index8(const int* v) {
+    static const uint32_t bits[4] = {1, 2, 4, 8};
+    int32x4_t lo = vld1q_s32(v);
+    int32x4_t hi = vld1q_s32(v + 4);
+    int32x4_t m = vdupq_n_s32(vminvq_s32(vminq_s32(lo, hi)));
+    uint32x4_t b = vld1q_u32(bits);
+    unsigned mask = vaddvq_u32(vandq_u32(vceqq_s32(lo, m), b));
+    mask |= vaddvq_u32(vandq_u32(vceqq_s32(hi, m), b)) << 4;
+    return __builtin_ctz(mask);
+}
+#endif
+
+/* Hole-based sift-down: the displaced value is held in a register and children
+ * move up until its slot is found. Partially filled last nodes fall back to the
+ * scalar scan. */
+#define HEAP_DEFINE_SIFT_DOWN(name, attr, D, MIN_INDEX)                 \
+    attr static void name(int* heap, int size, int idx) {               \
+        int value = heap[idx];                                          \
+        while (1) {                                                     \
+            int first = idx * D + 1;                                    \
+            if (first >= size) break;                                   \
+            int best = first + (first + D <= size                       \
+                                    ? MIN_INDEX(heap + first)           \
+                                    : scalar_min_index(heap + first, size - first)); \
+            if (heap[best] >= value) break;                             \
+            heap[idx] = heap[best];                                     \
+            idx = best;                                                 \
+        }                                                               \
+        heap[idx] = value;                                              \
+    }
+
+HEAP_DEFINE_SIFT_DOWN(sift_down_d4_scalar, , 4, scalar_min_index4)
+HEAP_DEFINE_SIFT_DOWN(sift_down_d8_scalar, , 8, scalar_min_index8)
+#ifdef HEAP_KERNELS_X86
+HEAP_DEFINE_SIFT_DOWN(sift_down_d4_sse41, __attribute__((target("sse4.1"))), 4, sse41_min_index4)
+HEAP_DEFINE_SIFT_DOWN(sift_down_d8_sse41, __attribute__((target("sse4.1"))), 8, sse41_min_index8)
+HEAP_DEFINE_SIFT_DOWN(sift_down_d8_avx2, __attribute__((target("avx2"))), 8, avx2_min_index8)
+#endif
+#ifdef HEAP_KERNELS_NEON
+HEAP_DEFINE_SIFT_DOWN(sift_down_d4_neon, , 4, neon_min_index4)
+HEAP_DEFINE_SIFT_DOWN(sift_down_d8_neon, , 8, neon_min_index8)
+#endif
+
+void heap_sift_down_d4(int* heap, int size, int idx) {
+    unsigned features = cpu_features();
+    (void)features;
+#ifdef HEAP_KERNELS_X86
+    if (features & CPU_FEATURE_SSE41) {
+        sift_down_d4_sse41(heap, size, idx);
+        return;
+    }
+#endif
+#ifdef HEAP_KERNELS_NEON
+    if (features & CPU_FEATURE_NEON) {
+        sift_down_d4_neon(heap, size, idx);
+        return;
+    }
+#endif
+    sift_down_d4_scalar(heap, size, idx);
+}
+
+void heap_sift_down_d8(int* heap, int size, int idx) {
+    unsigned features = cpu_features();
+    (void)features;
+#ifdef HEAP_KERNELS_X86
+    if (features & CPU_FEATURE_AVX2) {
+        sift_down_d8_avx2(heap, size, idx);
+        return;
+    }
+    if (features & CPU_FEATURE_SSE41) {
+        sift_down_d8_sse41(heap, size, idx);
+        return;
+    }
+#endif
+#ifdef HEAP_KERNELS_NEON
+    if (features & CPU_FEATURE_NEON) {
+        sift_down_d8_neon(heap, size, idx);
+        return;
+    }
+#endif
+    sift_down_d8_scalar(heap, size, idx);
+}
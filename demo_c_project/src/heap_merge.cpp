@@ -0,0 +1,230 @@
+#include "heap_merge.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "calculator.h"
+#include "dary_heap.hpp"
+#include "kv_heap.h"
+
+namespace {
+
+// Values handed to the sink per call.
+constexpr std::size_t kOutputBlock = 4096;
+// Smallest read buffer per run during the external merge.
+constexpr std::size_t kMinRunBuffer = 1024;
+
+unsigned thread_count(int threads) {
+    if (threads > 0) return static_cast<unsigned>(threads);
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+// Heapify with the binary layout min_heap_sort expects (dary_heap with D = 2
+// uses children 2i+1 and 2i+2), then drain in place.
+void sort_chunk(int* data, std::size_t n) {
+    dary_heap<int, 2>::heapify(data, n, std::less<int>());
+    min_heap_sort(data, static_cast<int>(n));
+}
+
+// Runs job(i) for i in [0, count) on up to `threads` threads, the caller
+// included. Threads that fail to start just leave more work for the others.
+void parallel_for(std::size_t count, unsigned threads, const std::function<void(std::size_t)>& job) {
+    std::atomic<std::size_t> next{0};
+    auto work = [&] {
+        for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) job(i);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads && t < count; ++t) {
+        try {
+            pool.emplace_back(work);
+        } catch (const std::system_error&) {
+            break;
+        }
+    }
+    work();
+    for (std::thread& th : pool) th.join();
+}
+
+// A sorted run consumed front to back. File-backed runs refill `buffer` from
+// their tmpfile; memory runs are a single block.
+struct run_source {
+    const int* cur = nullptr;
+    const int* end = nullptr;
+    FILE* file = nullptr;
+    std::vector<int> buffer;
+    bool failed = false;
+
+    bool next(int* out) {
+        if (cur == end && !refill()) return false;
+        *out = *cur++;
+        return true;
+    }
+
+    bool refill() {
+        if (!file) return false;
+        std::size_t got = std::fread(buffer.data(), sizeof(int), buffer.size(), file);
+        if (got < buffer.size() && std::ferror(file)) failed = true;
+        cur = buffer.data();
+        end = cur + got;
+        return got > 0;
+    }
+};
+
+int merge_sources(std::vector<run_source>& sources, heap_sink_fn sink, void* ctx) {
+    kv_heap_t heads;
+    if (kv_heap_init(&heads, static_cast<int>(sources.size())) != 0) return -1;
+    int status = 0;
+    int value;
+    for (run_source& s : sources) {
+        if (s.next(&value) && kv_heap_push(&heads, value, &s) != 0) status = -1;
+        // A run whose first read fails is never pushed, so check it here.
+        if (s.failed) status = -1;
+    }
+    std::vector<int> block;
+    try {
+        block.reserve(kOutputBlock);
+    } catch (const std::bad_alloc&) {
+        status = -1;
+    }
+    void* payload;
+    while (status == 0 && kv_heap_pop(&heads, &value, &payload) == 0) {
+        block.push_back(value);
+        run_source* s = static_cast<run_source*>(payload);
+        if (s->next(&value) && kv_heap_push(&heads, value, s) != 0) status = -1;
+        if (s->failed) status = -1;
+        if (block.size() == kOutputBlock) {
+            if (sink(ctx, block.data(), block.size()) != 0) status = -1;
+            block.clear();
+        }
+    }
+    if (status == 0 && !block.empty() && sink(ctx, block.data(), block.size()) != 0) status = -1;
+    kv_heap_destroy(&heads);
+    return status;
+}
+
+struct memory_sink {
+    int* out;
+};
+
+int write_memory(void* ctx, const int* values, std::size_t n) {
+    memory_sink* sink = static_cast<memory_sink*>(ctx);
+    std::memcpy(sink->out, values, n * sizeof(int));
+    sink->out += n;
+    return 0;
+}
+
+int write_file(void* ctx, const int* values, std::size_t n) {
+    return std::fwrite(values, sizeof(int), n, static_cast<FILE*>(ctx)) == n ? 0 : -1;
+}
+
+}  // namespace
+
+extern "C" {
+
+int heap_parallel_sort(int* data, size_t n, int threads) {
+    if (n < 2) return 0;
+    unsigned workers = thread_count(threads);
+    // min_heap_sort takes an int size, so no chunk may exceed INT_MAX.
+    std::size_t chunks = std::max<std::size_t>(workers, (n + INT_MAX - 1) / INT_MAX);
+    chunks = std::min(chunks, n);
+    std::size_t chunk_len = (n + chunks - 1) / chunks;
+    chunks = (n + chunk_len - 1) / chunk_len;
+    if (chunks == 1) {
+        sort_chunk(data, n);
+        return 0;
+    }
+    try {
+        std::unique_ptr<int[]> scratch(new int[n]);
+        int* runs = scratch.get();
+        parallel_for(chunks, workers, [&](std::size_t i) {
+            std::size_t lo = i * chunk_len;
+            std::size_t len = std::min(chunk_len, n - lo);
+            std::memcpy(runs + lo, data + lo, len * sizeof(int));
+            sort_chunk(runs + lo, len);
+        });
+        std::vector<run_source> sources(chunks);
+        for (std::size_t i = 0; i < chunks; ++i) {
+            sources[i].cur = runs + i * chunk_len;
+            sources[i].end = runs + std::min(n, (i + 1) * chunk_len);
+        }
+        memory_sink sink{data};
+        return merge_sources(sources, write_memory, &sink);
+    } catch (const std::bad_alloc&) {
+        return -1;
+    }
+}
+
+int heap_merge_runs(const int* const* runs, const size_t* lengths, int k, heap_sink_fn sink, void* ctx) {
+    try {
+        std::vector<run_source> sources(k > 0 ? static_cast<std::size_t>(k) : 0);
+        for (std::size_t i = 0; i < sources.size(); ++i) {
+            sources[i].cur = runs[i];
+            sources[i].end = runs[i] + lengths[i];
+        }
+        return merge_sources(sources, sink, ctx);
+    } catch (const std::bad_alloc&) {
+        return -1;
+    }
+}
+
+int heap_merge_files(FILE* const* runs, int k, size_t buffer_values, heap_sink_fn sink, void* ctx) {
+    try {
+        std::vector<run_source> sources(k > 0 ? static_cast<std::size_t>(k) : 0);
+        for (std::size_t i = 0; i < sources.size(); ++i) {
+            sources[i].file = runs[i];
+            sources[i].buffer.resize(std::max(buffer_values, kMinRunBuffer));
+        }
+        return merge_sources(sources, sink, ctx);
+    } catch (const std::bad_alloc&) {
+        return -1;
+    }
+}
+
+int heap_external_sort(FILE* in, FILE* out, size_t memory_bytes, int threads) {
+    std::size_t run_len = std::max<std::size_t>(memory_bytes / (2 * sizeof(int)), kMinRunBuffer);
+    std::vector<FILE*> files;
+    int status = 0;
+    try {
+        std::vector<int> chunk(run_len);
+        while (status == 0) {
+            std::size_t got = std::fread(chunk.data(), sizeof(int), run_len, in);
+            if (got < run_len && std::ferror(in)) status = -1;
+            if (got == 0) break;
+            if (heap_parallel_sort(chunk.data(), got, threads) != 0) {
+                status = -1;
+                break;
+            }
+            FILE* run = std::tmpfile();
+            if (!run) {
+                status = -1;
+                break;
+            }
+            files.push_back(run);
+            if (write_file(run, chunk.data(), got) != 0 || std::fflush(run) != 0) status = -1;
+            std::rewind(run);
+            if (got < run_len) break;
+        }
+        chunk = std::vector<int>();
+
+        if (status == 0) {
+            std::size_t per_run = memory_bytes / sizeof(int) / (files.size() + 1);
+            status = heap_merge_files(files.data(), static_cast<int>(files.size()), per_run, write_file, out);
+        }
+    } catch (const std::bad_alloc&) {
+        status = -1;
+    }
+    for (FILE* f : files) std::fclose(f);
+    if (status == 0 && std::fflush(out) != 0) status = -1;
+    return status;
+}
+
+}
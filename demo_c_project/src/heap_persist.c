@@ -0,0 +1,206 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "calculator.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Snapshot layout: this header followed by `size` ints in heap order.
+// Version 2 added header_check and hashes the payload a word at a time.
+#define SNAPSHOT_MAGIC 0x5048494du /* "MIHP" read little-endian */
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+typedef struct snapshot_header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t elem_size;
+    uint32_t byte_order;
+    uint32_t header_check; /* hash of the other header fields */
+    uint64_t size;
+    uint64_t checksum; /* hash of the payload */
+} snapshot_header_t;
+
+#define SNAPSHOT_HASH_PRIME 0x100000001b3ull
+
+static uint64_t snapshot_mix(uint64_t h, uint64_t word) {
+    return (h ^ word) * SNAPSHOT_HASH_PRIME ^ (h >> 29);
+}
+
+// FNV-style, but eight bytes per step: only verifying loads pay for the pass.
+static uint64_t snapshot_checksum(const int* data, size_t n) {
+    const unsigned char* p = (const unsigned char*)data;
+    size_t bytes = n * sizeof(int);
+    uint64_t h = 1469598103934665603ull;
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        memcpy(&word, p + i, 8);
+        h = snapshot_mix(h, word);
+    }
+    if (i < bytes) {
+        uint64_t word = 0;
+        memcpy(&word, p + i, bytes - i);
+        h = snapshot_mix(h, word);
+    }
+    return snapshot_mix(h, (uint64_t)bytes);
+}
+
+static uint32_t snapshot_header_check(const snapshot_header_t* h) {
+    uint64_t x = 1469598103934665603ull;
+    x = snapshot_mix(x, ((uint64_t)h->magic << 32) | ((uint64_t)h->version << 16) | h->elem_size);
+    x = snapshot_mix(x, h->byte_order);
+    x = snapshot_mix(x, h->size);
+    x = snapshot_mix(x, h->checksum);
+    return (uint32_t)(x ^ (x >> 32));
+}
+
+static int snapshot_header_valid(const snapshot_header_t* h, size_t payload_bytes) {
+    return h->magic == SNAPSHOT_MAGIC && h->version == SNAPSHOT_VERSION && h->elem_size == sizeof(int) &&
+           h->byte_order == SNAPSHOT_BYTE_ORDER && h->header_check == snapshot_header_check(h) &&
+           h->size <= (uint64_t)INT32_MAX && h->size * sizeof(int) == payload_bytes;
+}
+
+int min_heap_save(const min_heap_t* heap, const char* path) {
+    snapshot_header_t h;
+    memset(&h, 0, sizeof(h));
+    h.magic = SNAPSHOT_MAGIC;
+    h.version = SNAPSHOT_VERSION;
+    h.elem_size = sizeof(int);
+    h.byte_order = SNAPSHOT_BYTE_ORDER;
+    h.size = (uint64_t)heap->size;
+    h.checksum = snapshot_checksum(heap->data, (size_t)heap->size);
+    h.header_check = snapshot_header_check(&h);
+
+    // Write beside the target, flush it to disk, then rename over it, so a
+    // crash mid-save leaves either the previous snapshot or the complete new
+    // one. The directory entry itself is not synced: after a power loss the
+    // rename may not have happened yet.
+    size_t len = strlen(path);
+    char* tmp = (char*)malloc(len + 5);
+    if (!tmp) return -1;
+    memcpy(tmp, path, len);
+    memcpy(tmp + len, ".tmp", 5);
+    FILE* f = fopen(tmp, "wb");
+    int ok = f != NULL;
+    if (ok) {
+        ok = fwrite(&h, sizeof(h), 1, f) == 1;
+        if (ok && heap->size > 0) {
+            ok = fwrite(heap->data, sizeof(int), (size_t)heap->size, f) == (size_t)heap->size;
+        }
+        ok = ok && fflush(f) == 0;
+#if defined(_WIN32)
+        ok = ok && _commit(_fileno(f)) == 0;
+#else
+        ok = ok && fsync(fileno(f)) == 0;
+#endif
+        ok = fclose(f) == 0 && ok;
+    }
+#if defined(_WIN32)
+    // rename() cannot replace an existing file here; MoveFileEx swaps it in
+    // one step, so there is no window without a snapshot at `path`.
+    ok = ok && MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    ok = ok && rename(tmp, path) == 0;
+#endif
+    if (!ok) remove(tmp);
+    free(tmp);
+    return ok ? 0 : -1;
+}
+
+#if !defined(_WIN32)
+/* Every buffer owned by this allocator is a private mapping whose first
+ * sizeof(snapshot_header_t) bytes precede the int array, so buffers from
+ * min_heap_load_mmap and from later growth are released the same way. */
+static void* mapped_map(size_t bytes) {
+    void* p = mmap(NULL, sizeof(snapshot_header_t) + bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? NULL : (char*)p + sizeof(snapshot_header_t);
+}
+
+static void mapped_unmap(void* ptr, size_t bytes) {
+    munmap((char*)ptr - sizeof(snapshot_header_t), sizeof(snapshot_header_t) + bytes);
+}
+
+static void* mapped_alloc(void* ctx, size_t bytes) {
+    (void)ctx;
+    return mapped_map(bytes);
+}
+
+static void* mapped_resize(void* ctx, void* ptr, size_t old_bytes, size_t new_bytes) {
+    (void)ctx;
+    void* grown = mapped_map(new_bytes);
+    if (!grown) return NULL;
+    memcpy(grown, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+    mapped_unmap(ptr, old_bytes);
+    return grown;
+}
+
+static void mapped_release(void* ctx, void* ptr, size_t bytes) {
+    (void)ctx;
+    mapped_unmap(ptr, bytes);
+}
+
+static const min_heap_allocator_t mapped_allocator = {mapped_alloc, mapped_resize, mapped_release, NULL};
+
+int min_heap_load_mmap(min_heap_t* heap, const char* path, unsigned flags) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    void* base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(snapshot_header_t)) {
+        // Copy-on-write: pushes and pops dirty private pages, never the file.
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) return -1;
+
+    const snapshot_header_t* h = (const snapshot_header_t*)base;
+    int* data = (int*)((char*)base + sizeof(snapshot_header_t));
+    size_t payload = (size_t)st.st_size - sizeof(snapshot_header_t);
+    // Only the header is checked by default: hashing the payload would fault
+    // in every page of the mapping up front.
+    if (!snapshot_header_valid(h, payload) ||
+        ((flags & MIN_HEAP_LOAD_VERIFY) && snapshot_checksum(data, (size_t)h->size) != h->checksum)) {
+        munmap(base, (size_t)st.st_size);
+        return -1;
+    }
+    if (h->size == 0) {
+        munmap(base, (size_t)st.st_size);
+        return min_heap_init(heap, 0, &mapped_allocator);
+    }
+    heap->data = data;
+    heap->size = (int)h->size;
+    heap->capacity = (int)h->size;
+    heap->allocator = &mapped_allocator;
+    return 0;
+}
+#else
+// No mmap: read the snapshot into a malloc'd buffer owned by the default allocator.
+int min_heap_load_mmap(min_heap_t* heap, const char* path, unsigned flags) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+    snapshot_header_t h;
+    int ok = fread(&h, sizeof(h), 1, f) == 1 && h.size <= (uint64_t)INT32_MAX &&
+             snapshot_header_valid(&h, (size_t)h.size * sizeof(int));
+    ok = ok && min_heap_init(heap, (int)h.size, NULL) == 0;
+    if (ok && h.size > 0) {
+        ok = fread(heap->data, sizeof(int), (size_t)h.size, f) == (size_t)h.size &&
+             (!(flags & MIN_HEAP_LOAD_VERIFY) || snapshot_checksum(heap->data, (size_t)h.size) == h.checksum);
+        if (!ok) min_heap_destroy(heap);
+    }
+    fclose(f);
+    if (!ok) return -1;
+    heap->size = (int)h.size;
+    return 0;
+}
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+
+/* Binary-heap sift loops shared by the heap variants in src/. The element
+ * comparison and exchange are supplied as macros taking (heap, i, j) so each
+ * variant decides what moves: a bare int array, parallel key/payload arrays,
+ * packed entries or a position map.
+ *
+ * A file may define HEAP_SIFT_STAT(field, n) before including this header to
+ * count comparisons, swaps and levels (fields of min_heap_stats_t); it is a
+ * no-op otherwise. */
+#ifndef HEAP_SIFT_STAT
+#define HEAP_SIFT_STAT(field, n) ((void)0)
+#endif
+
+#define HEAP_DEFINE_SIFT(prefix, heap_t, LESS, SWAP)                           \
+    static inline void prefix##_sift_up(heap_t heap, int idx) {                \
+        while (idx > 0) {                                                      \
+            int parent = (idx - 1) / 2;                                        \
+            HEAP_SIFT_STAT(comparisons, 1);                                    \
+            if (!LESS(heap, idx, parent)) break;                               \
+            SWAP(heap, parent, idx);                                           \
+            HEAP_SIFT_STAT(swaps, 1);                                          \
+            HEAP_SIFT_STAT(sift_up_levels, 1);                                 \
+            idx = parent;                                                      \
+        }                                                                      \
+    }                                                                          \
+    static inline void prefix##_sift_down(heap_t heap, int size, int idx) {    \
+        while (1) {                                                            \
+            int left = idx * 2 + 1;                                            \
+            int right = idx * 2 + 2;                                           \
+            int smallest = idx;                                                \
+            HEAP_SIFT_STAT(comparisons, (left < size) + (right < size));       \
+            if (left < size && LESS(heap, left, smallest)) smallest = left;    \
+            if (right < size && LESS(heap, right, smallest)) smallest = right; \
+            if (smallest == idx) break;                                        \
+            SWAP(heap, smallest, idx);                                         \
+            HEAP_SIFT_STAT(swaps, 1);                                          \
+            HEAP_SIFT_STAT(sift_down_levels, 1);                               \
+            idx = smallest;                                                    \
+        }                                                                      \
+    }
+
+#define HEAP_ARRAY_LESS(heap, i, j) ((heap)[i] < (heap)[j])
+#define HEAP_ARRAY_SWAP(type, heap, i, j) \
+    do {                                  \
+        type heap_tmp_ = (heap)[i];       \
+        (heap)[i] = (heap)[j];            \
+        (heap)[j] = heap_tmp_;            \
+    } while (0)
@@ -0,0 +1,37 @@
+#include "heap_stats.h"
+
+#include <string.h>
+
+#include "calculator.h"
+
+#ifdef MIN_HEAP_STATS
+#if defined(_MSC_VER)
+__declspec(thread) __declspec(align(64)) heap_stats_slot_t heap_stats_tls;
+#else
+__thread heap_stats_slot_t heap_stats_tls __attribute__((aligned(64)));
+#endif
+
+int min_heap_stats_enabled(void) {
+    return 1;
+}
+
+int min_heap_stats_get(min_heap_stats_t* out) {
+    *out = heap_stats_tls.stats;
+    return 0;
+}
+
+void min_heap_stats_reset(void) {
+    memset(&heap_stats_tls.stats, 0, sizeof(heap_stats_tls.stats));
+}
+#else
+int min_heap_stats_enabled(void) {
+    return 0;
+}
+
+int min_heap_stats_get(min_heap_stats_t* out) {
+    memset(out, 0, sizeof(*out));
+    return -1;
+}
+
+void min_heap_stats_reset(void) {}
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+/* Hot-path counters for min_heap_t, compiled in only with -DMIN_HEAP_STATS
+ * (make STATS=1). Each thread increments its own slot, padded to a cache line
+ * so concurrent heaps never share one; without the flag HEAP_STAT_ADD expands
+ * to nothing and the sift loops are unchanged. */
+#ifdef MIN_HEAP_STATS
+#include "calculator.h"
+
+typedef union heap_stats_slot {
+    min_heap_stats_t stats;
+    char pad[64];
+} heap_stats_slot_t;
+
+#if defined(_MSC_VER)
+extern __declspec(thread) heap_stats_slot_t heap_stats_tls;
+#else
+extern __thread heap_stats_slot_t heap_stats_tls __attribute__((aligned(64)));
+#endif
+
+#define HEAP_STAT_ADD(field, n) (heap_stats_tls.stats.field += (unsigned long long)(n))
+#else
+#define HEAP_STAT_ADD(field, n) ((void)0)
+#endif
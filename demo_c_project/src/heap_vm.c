@@ -0,0 +1,161 @@
+#include <string.h>
+
+#include "calculator.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define VM_HUGE_PAGE ((size_t)2 << 20)
+
+static size_t vm_round_up(size_t bytes, size_t granule) {
+    return (bytes + granule - 1) / granule * granule;
+}
+
+#if defined(_WIN32)
+static void* vm_reserve(size_t bytes) {
+    return VirtualAlloc(NULL, bytes, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+static int vm_commit(void* p, size_t bytes) {
+    return VirtualAlloc(p, bytes, MEM_COMMIT, PAGE_READWRITE) ? 0 : -1;
+}
+
+static void vm_decommit(void* p, size_t bytes) {
+    VirtualFree(p, bytes, MEM_DECOMMIT);
+}
+
+static void vm_unreserve(void* p, size_t bytes) {
+    (void)bytes;
+    VirtualFree(p, 0, MEM_RELEASE);
+}
+#else
+static void* vm_reserve(size_t bytes) {
+    void* p = mmap(NULL, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+static int vm_commit(void* p, size_t bytes) {
+    return mprotect(p, bytes, PROT_READ | PROT_WRITE);
+}
+
+static void vm_decommit(void* p, size_t bytes) {
+    madvise(p, bytes, MADV_DONTNEED);
+    mprotect(p, bytes, PROT_NONE);
+}
+
+static void vm_unreserve(void* p, size_t bytes) {
+    munmap(p, bytes);
+}
+#endif
+
+// Commits [committed, bytes) or decommits [bytes, committed), page-rounded.
+static int vm_set_committed(min_heap_vm_arena_t* arena, size_t bytes) {
+    size_t want = vm_round_up(bytes, arena->page_size);
+    char* base = (char*)arena->base;
+    if (want > arena->committed) {
+        if (vm_commit(base + arena->committed, want - arena->committed) != 0) return -1;
+    } else if (want < arena->committed) {
+        vm_decommit(base + want, arena->committed - want);
+    }
+    arena->committed = want;
+    return 0;
+}
+
+static void* vm_alloc(void* ctx, size_t bytes) {
+    min_heap_vm_arena_t* arena = (min_heap_vm_arena_t*)ctx;
+    if (arena->in_use || bytes > arena->reserved) return NULL;
+    if (vm_set_committed(arena, bytes) != 0) return NULL;
+    arena->in_use = 1;
+    return arena->base;
+}
+
+// Grows or shrinks in place: the array never moves, so nothing is copied.
+static void* vm_resize(void* ctx, void* ptr, size_t old_bytes, size_t new_bytes) {
+    min_heap_vm_arena_t* arena = (min_heap_vm_arena_t*)ctx;
+    (void)old_bytes;
+    if (new_bytes > arena->reserved) return NULL;
+    if (vm_set_committed(arena, new_bytes) != 0) return NULL;
+    return ptr;
+}
+
+static void vm_release(void* ctx, void* ptr, size_t bytes) {
+    min_heap_vm_arena_t* arena = (min_heap_vm_arena_t*)ctx;
+    (void)ptr;
+    (void)bytes;
+    vm_set_committed(arena, 0);
+    arena->in_use = 0;
+}
+
+#if !defined(_WIN32)
+static int vm_bind_node(void* p, size_t bytes, int node) {
+#if defined(SYS_mbind)
+    // mbind(MPOL_BIND) via syscall so the library does not depend on libnuma.
+    unsigned long mask[4];
+    if (node < 0 || (size_t)node >= sizeof(mask) * 8) return -1;
+    memset(mask, 0, sizeof(mask));
+    mask[node / (sizeof(unsigned long) * 8)] = 1ul << (node % (sizeof(unsigned long) * 8));
+    return syscall(SYS_mbind, p, bytes, 2 /* MPOL_BIND */, mask, sizeof(mask) * 8, 0) == 0 ? 0 : -1;
+#else
+    (void)p;
+    (void)bytes;
+    (void)node;
+    return -1;
+#endif
+}
+#endif
+
+int min_heap_vm_arena_init(min_heap_vm_arena_t* arena, size_t max_bytes, unsigned flags, int numa_node) {
+    memset(arena, 0, sizeof(*arena));
+    if (max_bytes == 0) return -1;
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    arena->page_size = info.dwPageSize;
+    if (numa_node >= 0) return -1;
+    (void)flags;
+#else
+    arena->page_size = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+    arena->reserved = vm_round_up(max_bytes, VM_HUGE_PAGE);
+#if defined(MAP_HUGETLB)
+    if (flags & MIN_HEAP_VM_HUGETLB) {
+        // No MAP_NORESERVE here: the kernel must set aside the whole range from
+        // the hugetlb pool now, or a later fault on an empty pool is SIGBUS.
+        void* p = mmap(NULL, arena->reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            arena->base = p;
+            arena->page_size = VM_HUGE_PAGE;
+            arena->huge_pages = 1;
+        }
+    }
+#endif
+    if (!arena->base) arena->base = vm_reserve(arena->reserved);
+    if (!arena->base) return -1;
+#if defined(MADV_HUGEPAGE)
+    // Transparent huge pages are advisory: a kernel with THP disabled simply ignores the hint.
+    if (!arena->huge_pages && (flags & (MIN_HEAP_VM_THP | MIN_HEAP_VM_HUGETLB))) {
+        madvise(arena->base, arena->reserved, MADV_HUGEPAGE);
+    }
+#endif
+#if !defined(_WIN32)
+    if (numa_node >= 0 && vm_bind_node(arena->base, arena->reserved, numa_node) != 0) {
+        min_heap_vm_arena_destroy(arena);
+        return -1;
+    }
+#endif
+    arena->allocator.alloc = vm_alloc;
+    arena->allocator.resize = vm_resize;
+    arena->allocator.release = vm_release;
+    arena->allocator.ctx = arena;
+    return 0;
+}
+
+void min_heap_vm_arena_destroy(min_heap_vm_arena_t* arena) {
+    if (arena->base) vm_unreserve(arena->base, arena->reserved);
+    memset(arena, 0, sizeof(*arena));
+}
@@ -0,0 +1,115 @@
+#include "indexed_heap.h"
+#include "heap_sift.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define INDEXED_LESS(heap, i, j) HEAP_ARRAY_LESS((heap)->keys, i, j)
+#define INDEXED_SWAP(heap, i, j)                         \
+    do {                                                 \
+        HEAP_ARRAY_SWAP(int, (heap)->keys, i, j);        \
+        HEAP_ARRAY_SWAP(int, (heap)->handles, i, j);     \
+        (heap)->pos[(heap)->handles[i]] = (i);           \
+        (heap)->pos[(heap)->handles[j]] = (j);           \
+    } while (0)
+HEAP_DEFINE_SIFT(indexed, indexed_heap_t*, INDEXED_LESS, INDEXED_SWAP)
+
+static int grow(indexed_heap_t* heap, int capacity) {
+    int** arrays[] = {&heap->keys, &heap->handles, &heap->pos, &heap->free_handles};
+    for (size_t i = 0; i < sizeof(arrays) / sizeof(arrays[0]); ++i) {
+        int* resized = (int*)realloc(*arrays[i], (size_t)capacity * sizeof(int));
+        if (!resized) return -1;
+        *arrays[i] = resized;
+    }
+    for (int handle = capacity - 1; handle >= heap->capacity; --handle) {
+        heap->pos[handle] = -1;
+        heap->free_handles[heap->free_count++] = handle;
+    }
+    heap->capacity = capacity;
+    return 0;
+}
+
+static int valid_handle(const indexed_heap_t* heap, int handle) {
+    return handle >= 0 && handle < heap->capacity && heap->pos[handle] >= 0;
+}
+
+// Removes the element at heap position `idx` and recycles its handle.
+static void remove_at(indexed_heap_t* heap, int idx) {
+    int handle = heap->handles[idx];
+    int last = heap->size - 1;
+    if (idx != last) {
+        INDEXED_SWAP(heap, idx, last);
+    }
+    heap->size--;
+    heap->pos[handle] = -1;
+    heap->free_handles[heap->free_count++] = handle;
+    if (idx < heap->size) {
+        int moved = heap->handles[idx];
+        indexed_sift_up(heap, idx);
+        indexed_sift_down(heap, heap->size, heap->pos[moved]);
+    }
+}
+
+int indexed_heap_init(indexed_heap_t* heap, int capacity_hint) {
+    memset(heap, 0, sizeof(*heap));
+    return capacity_hint > 0 ? grow(heap, capacity_hint) : 0;
+}
+
+int indexed_heap_push(indexed_heap_t* heap, int key) {
+    if (heap->free_count == 0 && grow(heap, heap->capacity == 0 ? 10 : heap->capacity * 2) != 0) {
+        return -1;
+    }
+    int handle = heap->free_handles[--heap->free_count];
+    int idx = heap->size++;
+    heap->keys[idx] = key;
+    heap->handles[idx] = handle;
+    heap->pos[handle] = idx;
+    indexed_sift_up(heap, idx);
+    return handle;
+}
+
+int indexed_heap_pop(indexed_heap_t* heap, int* key, int* handle) {
+    if (indexed_heap_peek(heap, key, handle) != 0) return -1;
+    remove_at(heap, 0);
+    return 0;
+}
+
+int indexed_heap_peek(const indexed_heap_t* heap, int* key, int* handle) {
+    if (heap->size == 0) return -1;
+    if (key) *key = heap->keys[0];
+    if (handle) *handle = heap->handles[0];
+    return 0;
+}
+
+int indexed_heap_contains(const indexed_heap_t* heap, int handle) {
+    return valid_handle(heap, handle);
+}
+
+int indexed_heap_key(const indexed_heap_t* heap, int handle, int* key) {
+    if (!valid_handle(heap, handle)) return -1;
+    if (key) *key = heap->keys[heap->pos[handle]];
+    return 0;
+}
+
+int indexed_heap_decrease_key(indexed_heap_t* heap, int handle, int new_key) {
+    if (!valid_handle(heap, handle)) return -1;
+    int idx = heap->pos[handle];
+    if (new_key > heap->keys[idx]) return -1;
+    heap->keys[idx] = new_key;
+    indexed_sift_up(heap, idx);
+    return 0;
+}
+
+int indexed_heap_remove(indexed_heap_t* heap, int handle) {
+    if (!valid_handle(heap, handle)) return -1;
+    remove_at(heap, heap->pos[handle]);
+    return 0;
+}
+
+void indexed_heap_destroy(indexed_heap_t* heap) {
+    free(heap->keys);
+    free(heap->handles);
+    free(heap->pos);
+    free(heap->free_handles);
+    memset(heap, 0, sizeof(*heap));
+}
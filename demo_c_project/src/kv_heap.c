@@ -0,0 +1,177 @@
+#include "kv_heap.h"
+#include "heap_sift.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static int next_capacity(int capacity, int needed) {
+    int new_capacity = capacity == 0 ? 10 : capacity;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    return new_capacity;
+}
+
+/* ---- SoA ---- */
+
+/* Hole-based sifts instead of the shared swap macro: the moving record stays
+ * in registers and each level writes one key and one payload. Records the
+ * sift passes still shift one slot per level, payload included;
+ * kv_packed_heap_t is the layout that keeps payloads out of the loop. */
+static inline void kv_sift_up(kv_heap_t* heap, int idx) {
+    int* keys = heap->keys;
+    void** payloads = heap->payloads;
+    int key = keys[idx];
+    void* payload = payloads[idx];
+    while (idx > 0) {
+        int parent = (idx - 1) / 2;
+        if (!(key < keys[parent])) break;
+        keys[idx] = keys[parent];
+        payloads[idx] = payloads[parent];
+        idx = parent;
+    }
+    keys[idx] = key;
+    payloads[idx] = payload;
+}
+
+static inline void kv_sift_down(kv_heap_t* heap, int size, int idx) {
+    int* keys = heap->keys;
+    void** payloads = heap->payloads;
+    int key = keys[idx];
+    void* payload = payloads[idx];
+    while (1) {
+        int child = idx * 2 + 1;
+        if (child >= size) break;
+        if (child + 1 < size) child += keys[child + 1] < keys[child];
+        if (!(keys[child] < key)) break;
+        keys[idx] = keys[child];
+        payloads[idx] = payloads[child];
+        idx = child;
+    }
+    keys[idx] = key;
+    payloads[idx] = payload;
+}
+
+static int kv_set_capacity(kv_heap_t* heap, int capacity) {
+    int* keys = (int*)realloc(heap->keys, (size_t)capacity * sizeof(int));
+    if (!keys) return -1;
+    heap->keys = keys;
+    void** payloads = (void**)realloc(heap->payloads, (size_t)capacity * sizeof(void*));
+    if (!payloads) return -1;
+    heap->payloads = payloads;
+    heap->capacity = capacity;
+    return 0;
+}
+
+int kv_heap_init(kv_heap_t* heap, int capacity_hint) {
+    memset(heap, 0, sizeof(*heap));
+    return capacity_hint > 0 ? kv_set_capacity(heap, capacity_hint) : 0;
+}
+
+int kv_heap_push(kv_heap_t* heap, int key, void* payload) {
+    if (heap->size >= heap->capacity &&
+        kv_set_capacity(heap, next_capacity(heap->capacity, heap->size + 1)) != 0) {
+        return -1;
+    }
+    heap->keys[heap->size] = key;
+    heap->payloads[heap->size] = payload;
+    kv_sift_up(heap, heap->size);
+    heap->size++;
+    return 0;
+}
+
+int kv_heap_pop(kv_heap_t* heap, int* key, void** payload) {
+    if (kv_heap_peek(heap, key, payload) != 0) return -1;
+    heap->size--;
+    heap->keys[0] = heap->keys[heap->size];
+    heap->payloads[0] = heap->payloads[heap->size];
+    kv_sift_down(heap, heap->size, 0);
+    return 0;
+}
+
+int kv_heap_peek(const kv_heap_t* heap, int* key, void** payload) {
+    if (heap->size == 0) return -1;
+    if (key) *key = heap->keys[0];
+    if (payload) *payload = heap->payloads[0];
+    return 0;
+}
+
+void kv_heap_destroy(kv_heap_t* heap) {
+    free(heap->keys);
+    free(heap->payloads);
+    memset(heap, 0, sizeof(*heap));
+}
+
+/* ---- packed key|slot ---- */
+
+#define PACKED_SWAP(heap, i, j) HEAP_ARRAY_SWAP(uint64_t, heap, i, j)
+HEAP_DEFINE_SIFT(packed, uint64_t*, HEAP_ARRAY_LESS, PACKED_SWAP)
+
+static uint64_t pack_entry(int key, uint32_t slot) {
+    // Flipping the sign bit makes unsigned order match signed key order.
+    return ((uint64_t)((uint32_t)key ^ 0x80000000u) << 32) | slot;
+}
+
+static int unpack_key(uint64_t entry) {
+    return (int)((uint32_t)(entry >> 32) ^ 0x80000000u);
+}
+
+static int packed_set_capacity(kv_packed_heap_t* heap, int capacity) {
+    uint64_t* entries = (uint64_t*)realloc(heap->entries, (size_t)capacity * sizeof(uint64_t));
+    if (!entries) return -1;
+    heap->entries = entries;
+    void** slots = (void**)realloc(heap->slots, (size_t)capacity * sizeof(void*));
+    if (!slots) return -1;
+    heap->slots = slots;
+    uint32_t* free_slots = (uint32_t*)realloc(heap->free_slots, (size_t)capacity * sizeof(uint32_t));
+    if (!free_slots) return -1;
+    heap->free_slots = free_slots;
+    // Every live slot is referenced by an entry, so the new slots are all free.
+    for (int slot = capacity - 1; slot >= heap->capacity; --slot) {
+        heap->free_slots[heap->free_count++] = (uint32_t)slot;
+    }
+    heap->capacity = capacity;
+    return 0;
+}
+
+int kv_packed_heap_init(kv_packed_heap_t* heap, int capacity_hint) {
+    memset(heap, 0, sizeof(*heap));
+    return capacity_hint > 0 ? packed_set_capacity(heap, capacity_hint) : 0;
+}
+
+int kv_packed_heap_push(kv_packed_heap_t* heap, int key, void* payload) {
+    if (heap->free_count == 0 &&
+        packed_set_capacity(heap, next_capacity(heap->capacity, heap->size + 1)) != 0) {
+        return -1;
+    }
+    uint32_t slot = heap->free_slots[--heap->free_count];
+    heap->slots[slot] = payload;
+    heap->entries[heap->size] = pack_entry(key, slot);
+    packed_sift_up(heap->entries, heap->size);
+    heap->size++;
+    return 0;
+}
+
+int kv_packed_heap_pop(kv_packed_heap_t* heap, int* key, void** payload) {
+    if (kv_packed_heap_peek(heap, key, payload) != 0) return -1;
+    heap->free_slots[heap->free_count++] = (uint32_t)heap->entries[0];
+    heap->size--;
+    heap->entries[0] = heap->entries[heap->size];
+    packed_sift_down(heap->entries, heap->size, 0);
+    return 0;
+}
+
+int kv_packed_heap_peek(const kv_packed_heap_t* heap, int* key, void** payload) {
+    if (heap->size == 0) return -1;
+    uint64_t entry = heap->entries[0];
+    if (key) *key = unpack_key(entry);
+    if (payload) *payload = heap->slots[(uint32_t)entry];
+    return 0;
+}
+
+void kv_packed_heap_destroy(kv_packed_heap_t* heap) {
+    free(heap->entries);
+    free(heap->slots);
+    free(heap->free_slots);
+    memset(heap, 0, sizeof(*heap));
+}
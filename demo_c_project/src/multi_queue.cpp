@@ -0,0 +1,41 @@
+#include "multi_queue.h"
+#include "multi_queue.hpp"
+
+#include <new>
+
+struct multi_queue_int {
+    explicit multi_queue_int(int shards) : queue(shards > 0 ? static_cast<std::size_t>(shards) : 0) {}
+    multi_queue<int> queue;
+};
+
+extern "C" {
+
+multi_queue_int_t* multi_queue_create(int shards) {
+    try {
+        return new multi_queue_int(shards);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void multi_queue_destroy(multi_queue_int_t* queue) {
+    delete queue;
+}
+
+int multi_queue_push(multi_queue_int_t* queue, int value) {
+    try {
+        queue->queue.push(value);
+    } catch (const std::bad_alloc&) {
+        return -1;
+    }
+    return 0;
+}
+
+int multi_queue_pop(multi_queue_int_t* queue, int* out) {
+    int value = 0;
+    if (!queue->queue.try_pop(value)) return -1;
+    if (out) *out = value;
+    return 0;
+}
+
+}
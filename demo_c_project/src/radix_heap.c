@@ -0,0 +1,102 @@
+#include "radix_heap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Keys are stored with the sign bit flipped so unsigned order matches int order.
+static unsigned radix_encode(int key) {
+    return (unsigned)key ^ 0x80000000u;
+}
+
+static int radix_decode(unsigned key) {
+    return (int)(key ^ 0x80000000u);
+}
+
+// 0 for key == last, else 1 + index of the highest differing bit.
+static int radix_bucket_of(unsigned key, unsigned last) {
+    unsigned diff = key ^ last;
+    if (diff == 0) return 0;
+#if defined(_MSC_VER)
+    unsigned long bit;
+    _BitScanReverse(&bit, diff);
+    return (int)bit + 1;
+#else
+    return 32 - __builtin_clz(diff);
+#endif
+}
+
+static int radix_bucket_reserve(radix_heap_bucket_t* b, int needed) {
+    if (needed <= b->capacity) return 0;
+    int capacity = b->capacity ? b->capacity : 8;
+    while (capacity < needed) capacity *= 2;
+    unsigned* data = (unsigned*)realloc(b->data, (size_t)capacity * sizeof(unsigned));
+    if (!data) return -1;
+    b->data = data;
+    b->capacity = capacity;
+    return 0;
+}
+
+// Makes bucket 0 non-empty on a non-empty heap. Every key in bucket i > 0
+// shares the bits above bit i - 1 with `last`, so once `last` moves to the
+// bucket's minimum each of them lands in a strictly lower bucket; a key is
+// moved at most 32 times over its lifetime. Destinations are reserved before
+// anything moves, so an allocation failure leaves the heap unchanged.
+static int radix_refill(radix_heap_t* heap) {
+    if (heap->buckets[0].size > 0) return 0;
+    int i = 1;
+    while (heap->buckets[i].size == 0) ++i;
+    radix_heap_bucket_t* b = &heap->buckets[i];
+    unsigned min = b->data[0];
+    for (int j = 1; j < b->size; ++j) {
+        if (b->data[j] < min) min = b->data[j];
+    }
+    int counts[33] = {0};
+    for (int j = 0; j < b->size; ++j) counts[radix_bucket_of(b->data[j], min)]++;
+    for (int d = 0; d < i; ++d) {
+        if (radix_bucket_reserve(&heap->buckets[d], heap->buckets[d].size + counts[d]) != 0) return -1;
+    }
+    heap->last = min;
+    for (int j = 0; j < b->size; ++j) {
+        radix_heap_bucket_t* dst = &heap->buckets[radix_bucket_of(b->data[j], min)];
+        dst->data[dst->size++] = b->data[j];
+    }
+    b->size = 0;
+    return 0;
+}
+
+void radix_heap_init(radix_heap_t* heap) {
+    memset(heap, 0, sizeof(*heap));
+}
+
+int radix_heap_push(radix_heap_t* heap, int key) {
+    unsigned k = radix_encode(key);
+    if (k < heap->last) return -1;
+    radix_heap_bucket_t* b = &heap->buckets[radix_bucket_of(k, heap->last)];
+    if (radix_bucket_reserve(b, b->size + 1) != 0) return -1;
+    b->data[b->size++] = k;
+    heap->size++;
+    return 0;
+}
+
+int radix_heap_peek(radix_heap_t* heap, int* out) {
+    if (heap->size == 0) return -1;
+    if (radix_refill(heap) != 0) return -1;
+    *out = radix_decode(heap->last);
+    return 0;
+}
+
+int radix_heap_pop(radix_heap_t* heap, int* out) {
+    if (radix_heap_peek(heap, out) != 0) return -1;
+    heap->buckets[0].size--;
+    heap->size--;
+    return 0;
+}
+
+void radix_heap_destroy(radix_heap_t* heap) {
+    for (int i = 0; i < 33; ++i) free(heap->buckets[i].data);
+    radix_heap_init(heap);
+}
@@ -0,0 +1,11 @@
+#include "typed_heap.h"
+#include "typed_heap.hpp"
+
+TYPED_HEAP_DEFINE(i32_min_heap, int32_t, std::less<int32_t>)
+TYPED_HEAP_DEFINE(i32_max_heap, int32_t, std::greater<int32_t>)
+TYPED_HEAP_DEFINE(i64_min_heap, int64_t, std::less<int64_t>)
+TYPED_HEAP_DEFINE(i64_max_heap, int64_t, std::greater<int64_t>)
+TYPED_HEAP_DEFINE(f32_min_heap, float, std::less<float>)
+TYPED_HEAP_DEFINE(f32_max_heap, float, std::greater<float>)
+TYPED_HEAP_DEFINE(f64_min_heap, double, std::less<double>)
+TYPED_HEAP_DEFINE(f64_max_heap, double, std::greater<double>)
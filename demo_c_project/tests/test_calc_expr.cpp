@@ -0,0 +1,225 @@
+#include <climits>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "calc_expr.h"
+#include "calc_expr.hpp"
+#include "calculator.h"
+#include "gtest.h"
+
+TEST(CalcExpr, EvaluatesRowWithPrecedence) {
+    char error[128] = {0};
+    calc_expr_t* expr = calc_expr_compile("(a*b + c) % m - -2", error, sizeof(error));
+    ASSERT_TRUE(expr != nullptr);
+    ASSERT_EQ(calc_expr_var_count(expr), 4);
+    EXPECT_EQ(calc_expr_var_index(expr, "m"), 3);
+    EXPECT_EQ(calc_expr_var_index(expr, "z"), -1);
+    EXPECT_EQ(std::string(calc_expr_var_name(expr, 1)), "b");
+    const int vars[] = {6, 7, 5, 10};
+    int err = -1;
+    EXPECT_EQ(calc_expr_eval(expr, vars, &err), (6 * 7 + 5) % 10 + 2);
+    EXPECT_EQ(err, 0);
+    calc_expr_destroy(expr);
+}
+
+TEST(CalcExpr, FoldsConstants) {
+    calc_expr_t* expr = calc_expr_compile("2 * (3 + 4) - -1", nullptr, 0);
+    ASSERT_TRUE(expr != nullptr);
+    EXPECT_EQ(calc_expr_code_size(expr), 1);
+    int err = -1;
+    EXPECT_EQ(calc_expr_eval(expr, nullptr, &err), 15);
+    calc_expr_destroy(expr);
+
+    expr = calc_expr_compile("x * (10 / 5) + 100 % 7", nullptr, 0);
+    ASSERT_TRUE(expr != nullptr);
+    EXPECT_EQ(calc_expr_code_size(expr), 5);
+    int x = 4;
+    EXPECT_EQ(calc_expr_eval(expr, &x, &err), 10);
+    calc_expr_destroy(expr);
+}
+
+TEST(CalcExpr, DivisionByZeroSetsError) {
+    calc_expr_t* expr = calc_expr_compile("a / b + 1 / 0", nullptr, 0);
+    ASSERT_TRUE(expr != nullptr);
+    const int vars[] = {8, 2};
+    int err = 0;
+    EXPECT_EQ(calc_expr_eval(expr, vars, &err), 4);
+    EXPECT_EQ(err, 1);
+    calc_expr_destroy(expr);
+
+    expr = calc_expr_compile("a % b", nullptr, 0);
+    const int zero[] = {8, 0};
+    EXPECT_EQ(calc_expr_eval(expr, zero, &err), 0);
+    EXPECT_EQ(err, 1);
+    EXPECT_EQ(calc_expr_eval(expr, vars, &err), calculator_mod(8, 2, nullptr));
+    EXPECT_EQ(err, 0);
+    calc_expr_destroy(expr);
+}
+
+TEST(CalcExpr, ReportsSyntaxErrors) {
+    const char* bad[] = {"", "a +", "(a * b", "a b", "3 $ 4", "99999999999"};
+    for (const char* source : bad) {
+        char error[128] = {0};
+        EXPECT_TRUE(calc_expr_compile(source, error, sizeof(error)) == nullptr);
+        EXPECT_TRUE(error[0] != '\0');
+    }
+}
+
+TEST(CalcExpr, RejectsDeepNestingWithoutRecursingFurther) {
+    // Deep enough to overflow the stack if the parser kept recursing.
+    const std::string parens(300000, '(');
+    const std::string signs(300000, '-');
+    for (const std::string& source : {parens + "1", signs + "x", std::string(300000, '+') + "1"}) {
+        char error[128] = {0};
+        EXPECT_TRUE(calc_expr_compile(source.c_str(), error, sizeof(error)) == nullptr);
+        EXPECT_TRUE(std::string(error).find("nests too deeply") != std::string::npos);
+    }
+    calc_expr_t* expr = calc_expr_compile((std::string(200, '(') + "7" + std::string(200, ')')).c_str(), nullptr, 0);
+    ASSERT_TRUE(expr != nullptr);
+    int err = 0;
+    EXPECT_EQ(calc_expr_eval(expr, nullptr, &err), 7);
+    calc_expr_destroy(expr);
+}
+
+TEST(CalcExpr, OperandStackCoversTheNestingLimit) {
+    // "x+x*(" leaves two operands pending per level, the deepest stack any
+    // parenthesis can build, so only the nesting limit may reject these.
+    auto chain = [](int levels) {
+        std::string source;
+        for (int i = 0; i < levels; ++i) source += "x+x*(";
+        return source + "x+x*x" + std::string(levels, ')');
+    };
+    calc_expr_t* expr = calc_expr_compile(chain(256).c_str(), nullptr, 0);
+    ASSERT_TRUE(expr != nullptr);
+    const int x = 1;
+    int err = -1;
+    EXPECT_EQ(calc_expr_eval(expr, &x, &err), 258);
+    EXPECT_EQ(err, 0);
+    const int* columns[] = {&x};
+    int out = 0;
+    EXPECT_EQ(calc_expr_eval_n(expr, columns, &out, nullptr, 1), 0);
+    EXPECT_EQ(out, 258);
+    calc_expr_destroy(expr);
+
+    char error[128] = {0};
+    EXPECT_TRUE(calc_expr_compile(chain(257).c_str(), error, sizeof(error)) == nullptr);
+    EXPECT_TRUE(std::string(error).find("nests too deeply") != std::string::npos);
+}
+
+TEST(CalcExpr, AcceptsIntMinLiteral) {
+    calc_expr_t* expr = calc_expr_compile("-2147483648 + x", nullptr, 0);
+    ASSERT_TRUE(expr != nullptr);
+    int x = 5, err = 0;
+    EXPECT_EQ(calc_expr_eval(expr, &x, &err), INT_MIN + 5);
+    calc_expr_destroy(expr);
+    expr = calc_expr_compile("- 2147483648", nullptr, 0);
+    ASSERT_TRUE(expr != nullptr);
+    EXPECT_EQ(calc_expr_eval(expr, nullptr, &err), INT_MIN);
+    calc_expr_destroy(expr);
+    expr = calc_expr_compile("--5 - -(3)", nullptr, 0);
+    ASSERT_TRUE(expr != nullptr);
+    EXPECT_EQ(calc_expr_eval(expr, nullptr, &err), 8);
+    calc_expr_destroy(expr);
+    const char* bad[] = {"2147483648", "-2147483649", "-(2147483648)"};
+    for (const char* source : bad) EXPECT_TRUE(calc_expr_compile(source, nullptr, 0) == nullptr);
+}
+
+TEST(CalcExpr, ColumnEvaluationMatchesRowEvaluation) {
+    const char* sources[] = {"(a*b + c) % m", "a - b * 3 + 7", "-a / (b - c)", "100 - a % 9", "17 / b", "5",
+                             "c * 2 / 0", "7 - -(a + b)"};
+    const size_t n = 1000;
+    const std::string names = "abcm";
+    std::vector<int> cols[4];
+    for (auto& col : cols) {
+        col.resize(n);
+        for (auto& v : col) v = rand() % 200 - 100;
+    }
+    for (const char* source : sources) {
+        calc_expr_t* expr = calc_expr_compile(source, nullptr, 0);
+        ASSERT_TRUE(expr != nullptr);
+        std::vector<const int*> columns;
+        for (int v = 0; v < calc_expr_var_count(expr); ++v) {
+            columns.push_back(cols[names.find(calc_expr_var_name(expr, v))].data());
+        }
+        std::vector<int> out(n);
+        std::vector<unsigned char> bits((n + 7) / 8, 0xee);
+        int any = calc_expr_eval_n(expr, columns.data(), out.data(), bits.data(), n);
+        bool expected_any = false;
+        for (size_t i = 0; i < n; ++i) {
+            std::vector<int> row;
+            for (const int* col : columns) row.push_back(col[i]);
+            int err = 0;
+            int expected = calc_expr_eval(expr, row.data(), &err);
+            expected_any |= err != 0;
+            EXPECT_EQ(out[i], expected);
+            EXPECT_EQ((bits[i / 8] >> (i % 8)) & 1, err);
+        }
+        EXPECT_EQ(any, expected_any ? 1 : 0);
+        calc_expr_destroy(expr);
+    }
+}
+
+TEST(CalcExpr, ClosureMatchesInterpreter) {
+    const char* sources[] = {"(a*b + c) % m", "a - b * 3 + 7", "-a / (b - c)", "100 - a % 9", "17 / b", "5", "b",
+                             "c * 2 / 0", "7 - -(a + b)", "-m"};
+    const size_t n = 1000;
+    const std::string names = "abcm";
+    std::vector<int> cols[4];
+    for (auto& col : cols) {
+        col.resize(n);
+        for (auto& v : col) v = rand() % 200 - 100;
+    }
+    for (const char* source : sources) {
+        calc_expr_t* expr = calc_expr_compile(source, nullptr, 0);
+        ASSERT_TRUE(expr != nullptr);
+        calc_expr_closure_t* closure = calc_expr_closure_compile(expr);
+        ASSERT_TRUE(closure != nullptr);
+        std::vector<const int*> columns;
+        for (int v = 0; v < calc_expr_var_count(expr); ++v) {
+            columns.push_back(cols[names.find(calc_expr_var_name(expr, v))].data());
+        }
+        std::vector<int> expected(n), out(n);
+        std::vector<unsigned char> expected_bits((n + 7) / 8), bits((n + 7) / 8, 0xee);
+        int expected_any = calc_expr_eval_n(expr, columns.data(), expected.data(), expected_bits.data(), n);
+        EXPECT_EQ(calc_expr_closure_eval_n(closure, columns.data(), out.data(), bits.data(), n), expected_any);
+        EXPECT_TRUE(out == expected);
+        EXPECT_TRUE(bits == expected_bits);
+        for (size_t i = 0; i < n; i += 97) {
+            std::vector<int> row;
+            for (const int* col : columns) row.push_back(col[i]);
+            int err = -1;
+            EXPECT_EQ(calc_expr_closure_eval(closure, row.data(), &err), expected[i]);
+            EXPECT_EQ(err, (expected_bits[i / 8] >> (i % 8)) & 1);
+        }
+        calc_expr_closure_destroy(closure);
+        calc_expr_destroy(expr);
+    }
+}
+
+TEST(CalcExpr, TemplateMatchesInterpreter) {
+    using namespace calc;
+    auto rule = (var<0>() * var<1>() + var<2>()) % var<3>() - -var<0>() / constant<7>() + 3;
+    calc_expr_t* expr = calc_expr_compile("(a*b + c) % m - -a / 7 + 3", nullptr, 0);
+    ASSERT_TRUE(expr != nullptr);
+    const size_t n = 500;
+    std::vector<int> cols[4];
+    for (auto& col : cols) {
+        col.resize(n);
+        for (auto& v : col) v = rand() % 20 - 10;
+    }
+    cols[0][0] = INT_MIN;
+    cols[1][0] = -1;
+    const int* columns[] = {cols[0].data(), cols[1].data(), cols[2].data(), cols[3].data()};
+    std::vector<int> expected(n), out(n);
+    std::vector<unsigned char> expected_bits((n + 7) / 8), bits((n + 7) / 8);
+    int expected_any = calc_expr_eval_n(expr, columns, expected.data(), expected_bits.data(), n);
+    EXPECT_EQ(rule.eval_n(columns, out.data(), bits.data(), n), expected_any);
+    EXPECT_TRUE(out == expected);
+    EXPECT_TRUE(bits == expected_bits);
+
+    const int row[] = {9, 4, 2, 0};
+    int err = 0;
+    EXPECT_EQ(rule.eval(row, &err), calc_expr_eval(expr, row, nullptr));
+    EXPECT_EQ(err, 1);
+    calc_expr_destroy(expr);
+}
@@ -0,0 +1,114 @@
+#include <climits>
+#include <random>
+#include <thread>
+#include <vector>
+// calc_expr.hpp is included to check its op enum and calc_service.h coexist.
+#include "calc_expr.hpp"
+#include "calc_service.h"
+#include "calculator.h"
+#include "gtest.h"
+#include "spsc_ring.hpp"
+
+namespace {
+
+calc_cqe_t expected_for(const calc_sqe_t& sqe) {
+    calc_cqe_t cqe{sqe.user_data, 0, 0};
+    if (sqe.a == INT_MIN && sqe.b == -1 && (sqe.op == CALC_SVC_OP_DIVIDE || sqe.op == CALC_SVC_OP_MOD)) {
+        // Traps in the scalar functions; the kernels wrap like the other ops.
+        cqe.result = sqe.op == CALC_SVC_OP_DIVIDE ? INT_MIN : 0;
+        return cqe;
+    }
+    switch (sqe.op) {
+        // The operands overflow; the kernels are documented to wrap, and
+        // unsigned arithmetic computes that without signed-overflow UB.
+        case CALC_SVC_OP_ADD: cqe.result = (int)((unsigned)sqe.a + (unsigned)sqe.b); break;
+        case CALC_SVC_OP_SUBTRACT: cqe.result = (int)((unsigned)sqe.a - (unsigned)sqe.b); break;
+        case CALC_SVC_OP_MULTIPLY: cqe.result = (int)((unsigned)sqe.a * (unsigned)sqe.b); break;
+        case CALC_SVC_OP_DIVIDE: cqe.result = divide(sqe.a, sqe.b, &cqe.error); break;
+        case CALC_SVC_OP_MOD: cqe.result = calculator_mod(sqe.a, sqe.b, &cqe.error); break;
+        default: cqe.error = -1; break;
+    }
+    return cqe;
+}
+
+}  // namespace
+
+TEST(SpscRing, WrapsAndReportsPartialTransfers) {
+    spsc_ring<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+    int in[12], out[12];
+    for (int i = 0; i < 12; ++i) in[i] = i;
+    for (int round = 0; round < 3; ++round) {
+        EXPECT_EQ(ring.push(in, 12), 8u);
+        EXPECT_EQ(ring.free_space(), 0u);
+        EXPECT_EQ(ring.pop(out, 3), 3u);
+        EXPECT_EQ(ring.push(in + 8, 4), 3u);
+        EXPECT_EQ(ring.pop(out + 3, 12), 8u);
+        for (int i = 0; i < 11; ++i) EXPECT_EQ(out[i], i);
+        EXPECT_TRUE(ring.empty());
+    }
+}
+
+TEST(CalcService, ClientsOnManyThreadsGetScalarResults) {
+    calc_service_t* service = calc_service_create(2, 0);
+    ASSERT_TRUE(service != nullptr);
+    const int kThreads = 4;
+    const int kRequests = 20000;
+    std::vector<int> mismatches(kThreads, 0);
+    const unsigned seed = testing::GetRandomSeed();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([service, t, seed, &mismatches] {
+            calc_client_t* client = calc_client_create(service, 64);
+            std::mt19937 rng(seed + t);
+            std::vector<calc_sqe_t> sqes(kRequests);
+            for (int i = 0; i < kRequests; ++i) {
+                int op = static_cast<int>(rng() % 6);  // 5 is an invalid op
+                int b = static_cast<int>(rng() % 7) - 3;
+                sqes[i] = {op, static_cast<int>(rng()), i % 97 == 0 ? -1 : b, static_cast<unsigned long long>(i)};
+                if (i % 101 == 0) sqes[i] = {i % 2 ? CALC_SVC_OP_DIVIDE : CALC_SVC_OP_MOD, INT_MIN, -1, static_cast<unsigned long long>(i)};
+            }
+            int submitted = 0, completed = 0;
+            calc_cqe_t cqes[64];
+            while (completed < kRequests) {
+                submitted += calc_client_submit(client, sqes.data() + submitted, kRequests - submitted);
+                int got = calc_client_wait(client, cqes, 64, 1);
+                for (int j = 0; j < got; ++j) {
+                    // Completions arrive in submission order.
+                    calc_cqe_t want = expected_for(sqes[completed + j]);
+                    if (cqes[j].user_data != want.user_data || cqes[j].result != want.result ||
+                        cqes[j].error != want.error) {
+                        mismatches[t]++;
+                    }
+                }
+                completed += got;
+            }
+            calc_client_destroy(client);
+        });
+    }
+    for (std::thread& th : threads) th.join();
+    for (int t = 0; t < kThreads; ++t) EXPECT_EQ(mismatches[t], 0);
+    calc_service_destroy(service);
+}
+
+TEST(CalcService, FullCompletionRingStallsOnlyThatClient) {
+    calc_service_t* service = calc_service_create(1, 1);
+    ASSERT_TRUE(service != nullptr);
+    calc_client_t* stalled = calc_client_create(service, 4);
+    calc_client_t* live = calc_client_create(service, 4);
+    calc_sqe_t sqes[8];
+    for (int i = 0; i < 8; ++i) sqes[i] = {CALC_SVC_OP_ADD, i, 1, static_cast<unsigned long long>(i)};
+    EXPECT_EQ(calc_client_submit(stalled, sqes, 8), 4);
+    calc_cqe_t cqes[8];
+    // Wait until the stalled client's completion ring is full and its
+    // submission ring drained, then refill the submission ring.
+    while (calc_client_submit(stalled, sqes + 4, 4) == 0) std::this_thread::yield();
+    EXPECT_EQ(calc_client_submit(live, sqes, 3), 3);
+    EXPECT_EQ(calc_client_wait(live, cqes, 8, 3), 3);
+    EXPECT_EQ(cqes[2].result, 3);
+    EXPECT_EQ(calc_client_wait(stalled, cqes, 8, 8), 8);
+    for (int i = 0; i < 8; ++i) EXPECT_EQ(cqes[i].result, i + 1);
+    calc_client_destroy(stalled);
+    calc_client_destroy(live);
+    calc_service_destroy(service);
+}
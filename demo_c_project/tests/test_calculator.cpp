@@ -1,17 +1,27 @@
 #include <cctype>
+#include <climits>
+#include <cstdio>
 #include <cstdlib>
+#include <random>
 #include <string>
 #include "calculator.h"
 #include "gtest.h"
 #include <vector>
 #include <algorithm>
+#if defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
 
 TEST(Calculator, HeavyLoadTest) {
     int* heap = nullptr;
     int size = 0;
     int capacity = 0;
+    std::mt19937 rng(testing::GetRandomSeed());
     for (int i = 0; i < 1000; ++i) {
-        min_heap_insert(&heap, &size, &capacity, rand() % 10000);
+        min_heap_insert(&heap, &size, &capacity, static_cast<int>(rng() % 10000));
     }
     std::vector<int> sorted_elements;
     while (size > 0) {
@@ -26,6 +36,315 @@ TEST(Calculator, HeavyLoadTest) {
     destroy_queue(&heap, &size, &capacity);
 }
 
+TEST(Calculator, BuildsHeapFromArray) {
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(rand() % 10000);
+    }
+    int* heap = nullptr;
+    int size = 0;
+    int capacity = 0;
+    min_heap_build(&heap, &size, &capacity, values.data(), static_cast<int>(values.size()));
+    ASSERT_EQ(size, 1000);
+    EXPECT_EQ(capacity, 1000);
+    std::sort(values.begin(), values.end());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(min_heap_delete_min(&heap, &size), values[i]);
+    }
+    EXPECT_EQ(size, 0);
+    destroy_queue(&heap, &size, &capacity);
+}
+
+TEST(Calculator, InsertsManyIntoHeap) {
+    int* heap = nullptr;
+    int size = 0;
+    int capacity = 0;
+    const int first[] = {5, 3, 9};
+    const int second[] = {7, 1};
+    min_heap_insert_many(&heap, &size, &capacity, first, 3);
+    min_heap_insert_many(&heap, &size, &capacity, second, 2);
+    min_heap_insert(&heap, &size, &capacity, 4);
+    ASSERT_EQ(size, 6);
+    EXPECT_EQ(capacity, 10);
+    const int expected[] = {1, 3, 4, 5, 7, 9};
+    for (int value : expected) {
+        EXPECT_EQ(min_heap_delete_min(&heap, &size), value);
+    }
+    destroy_queue(&heap, &size, &capacity);
+}
+
+TEST(Calculator, DeletesMinBatch) {
+    int* heap = nullptr;
+    int size = 0;
+    int capacity = 0;
+    for (int i = 0; i < 1000; ++i) {
+        min_heap_insert(&heap, &size, &capacity, rand() % 10000);
+    }
+    std::vector<int> copy(heap, heap + size);
+    std::sort(copy.begin(), copy.end());
+    std::vector<int> drained(copy.size());
+    int popped = min_heap_delete_min_n(&heap, &size, drained.data(), 100);
+    ASSERT_EQ(popped, 100);
+    EXPECT_EQ(size, 900);
+    popped += min_heap_delete_min_n(&heap, &size, drained.data() + popped, 5000);
+    ASSERT_EQ(popped, 1000);
+    EXPECT_EQ(size, 0);
+    EXPECT_TRUE(drained == copy);
+    EXPECT_EQ(min_heap_delete_min_n(&heap, &size, drained.data(), 1), 0);
+    destroy_queue(&heap, &size, &capacity);
+}
+
+TEST(Calculator, SortsHeapInPlace) {
+    int* heap = nullptr;
+    int size = 0;
+    int capacity = 0;
+    for (int i = 0; i < 1000; ++i) {
+        min_heap_insert(&heap, &size, &capacity, rand() % 10000);
+    }
+    std::vector<int> copy(heap, heap + size);
+    std::sort(copy.begin(), copy.end());
+    min_heap_sort(heap, size);
+    EXPECT_TRUE(std::vector<int>(heap, heap + size) == copy);
+    // A sorted array is still a valid heap.
+    min_heap_insert(&heap, &size, &capacity, -5);
+    EXPECT_EQ(min_heap_delete_min(&heap, &size), -5);
+    EXPECT_EQ(min_heap_delete_min(&heap, &size), copy[0]);
+    destroy_queue(&heap, &size, &capacity);
+}
+
+namespace {
+struct CountingArena {
+    int allocs = 0;
+    int resizes = 0;
+    int releases = 0;
+    size_t live_bytes = 0;
+};
+
+void* CountingAlloc(void* ctx, size_t bytes) {
+    auto* arena = static_cast<CountingArena*>(ctx);
+    arena->allocs++;
+    arena->live_bytes += bytes;
+    return malloc(bytes);
+}
+
+void* CountingResize(void* ctx, void* ptr, size_t old_bytes, size_t new_bytes) {
+    auto* arena = static_cast<CountingArena*>(ctx);
+    arena->resizes++;
+    arena->live_bytes += new_bytes - old_bytes;
+    return realloc(ptr, new_bytes);
+}
+
+void CountingRelease(void* ctx, void* ptr, size_t bytes) {
+    auto* arena = static_cast<CountingArena*>(ctx);
+    arena->releases++;
+    arena->live_bytes -= bytes;
+    free(ptr);
+}
+
+// Snapshot file named after the test and the process, removed (with any
+// leftover .tmp from min_heap_save) when the test returns or an ASSERT bails.
+struct ScopedSnapshotPath {
+    std::string path;
+    explicit ScopedSnapshotPath(const char* test)
+        : path(std::string("heap_snapshot_") + test + "_" + std::to_string(getpid()) + ".bin") {}
+    ~ScopedSnapshotPath() {
+        std::remove(path.c_str());
+        std::remove((path + ".tmp").c_str());
+    }
+    const char* c_str() const { return path.c_str(); }
+};
+}  // namespace
+
+TEST(Calculator, HeapHandleUsesCustomAllocator) {
+    CountingArena arena;
+    min_heap_allocator_t allocator = {CountingAlloc, CountingResize, CountingRelease, &arena};
+    min_heap_t heap;
+    ASSERT_EQ(min_heap_init(&heap, 64, &allocator), 0);
+    EXPECT_EQ(heap.capacity, 64);
+    EXPECT_EQ(arena.allocs, 1);
+    for (int i = 0; i < 64; ++i) {
+        EXPECT_EQ(min_heap_push(&heap, 63 - i), 0);
+    }
+    EXPECT_EQ(arena.resizes, 0);
+    EXPECT_EQ(min_heap_push(&heap, 100), 0);
+    EXPECT_EQ(heap.capacity, 128);
+    EXPECT_EQ(arena.resizes, 1);
+    EXPECT_EQ(min_heap_shrink_to_fit(&heap), 0);
+    EXPECT_EQ(heap.capacity, 65);
+    EXPECT_EQ(arena.live_bytes, 65 * sizeof(int));
+    int value = -1;
+    EXPECT_EQ(min_heap_peek(&heap, &value), 0);
+    EXPECT_EQ(value, 0);
+    int out[3];
+    EXPECT_EQ(min_heap_pop_n(&heap, out, 3), 3);
+    EXPECT_EQ(out[2], 2);
+    EXPECT_EQ(min_heap_pop(&heap, &value), 0);
+    EXPECT_EQ(value, 3);
+    min_heap_destroy(&heap);
+    EXPECT_EQ(arena.releases, 1);
+    EXPECT_EQ(arena.live_bytes, 0u);
+    EXPECT_EQ(min_heap_pop(&heap, &value), -1);
+    EXPECT_EQ(min_heap_peek(&heap, &value), -1);
+}
+
+TEST(Calculator, HeapHandleDefaultAllocator) {
+    min_heap_t heap;
+    ASSERT_EQ(min_heap_init(&heap, 0, nullptr), 0);
+    EXPECT_TRUE(heap.data == nullptr);
+    const int values[] = {9, 4, 7, 1};
+    EXPECT_EQ(min_heap_assign(&heap, values, 4), 0);
+    EXPECT_EQ(min_heap_reserve(&heap, 100), 0);
+    EXPECT_EQ(heap.capacity, 100);
+    const int more[] = {3, 0};
+    EXPECT_EQ(min_heap_push_many(&heap, more, 2), 0);
+    const int expected[] = {0, 1, 3, 4, 7, 9};
+    for (int e : expected) {
+        int value = -1;
+        EXPECT_EQ(min_heap_pop(&heap, &value), 0);
+        EXPECT_EQ(value, e);
+    }
+    EXPECT_EQ(min_heap_shrink_to_fit(&heap), 0);
+    EXPECT_TRUE(heap.data == nullptr);
+    EXPECT_EQ(heap.capacity, 0);
+    min_heap_destroy(&heap);
+}
+
+TEST(Calculator, HeapSnapshotRoundTripsThroughMmap) {
+    const ScopedSnapshotPath snapshot("roundtrip");
+    const char* path = snapshot.c_str();
+    min_heap_t heap;
+    ASSERT_EQ(min_heap_init(&heap, 0, nullptr), 0);
+    std::mt19937 rng(testing::GetRandomSeed());
+    for (int i = 0; i < 5000; ++i) min_heap_push(&heap, static_cast<int>(rng() % 100000));
+    ASSERT_EQ(min_heap_save(&heap, path), 0);
+
+    min_heap_t loaded;
+    ASSERT_EQ(min_heap_load_mmap(&loaded, path, MIN_HEAP_LOAD_VERIFY), 0);
+    ASSERT_EQ(loaded.size, heap.size);
+    EXPECT_TRUE(std::equal(heap.data, heap.data + heap.size, loaded.data));
+    // Mutating the copy-on-write mapping, including growth, leaves the file alone.
+    EXPECT_EQ(min_heap_push(&loaded, -1), 0);
+    int value = 0;
+    EXPECT_EQ(min_heap_pop(&loaded, &value), 0);
+    EXPECT_EQ(value, -1);
+    int prev = INT_MIN;
+    while (min_heap_pop(&loaded, &value) == 0) {
+        EXPECT_TRUE(value >= prev);
+        prev = value;
+    }
+    min_heap_destroy(&loaded);
+
+    ASSERT_EQ(min_heap_load_mmap(&loaded, path, 0), 0);
+    EXPECT_EQ(loaded.size, 5000);
+    min_heap_destroy(&loaded);
+    min_heap_destroy(&heap);
+}
+
+TEST(Calculator, HeapSnapshotRejectsCorruption) {
+    const ScopedSnapshotPath snapshot("corrupt");
+    const ScopedSnapshotPath missing("missing");
+    const char* path = snapshot.c_str();
+    min_heap_t heap;
+    ASSERT_EQ(min_heap_init(&heap, 0, nullptr), 0);
+    ASSERT_EQ(min_heap_save(&heap, path), 0);
+    min_heap_t loaded;
+    ASSERT_EQ(min_heap_load_mmap(&loaded, path, MIN_HEAP_LOAD_VERIFY), 0);
+    EXPECT_EQ(loaded.size, 0);
+    EXPECT_EQ(min_heap_push(&loaded, 3), 0);
+    min_heap_destroy(&loaded);
+
+    const int values[] = {5, 1, 4};
+    ASSERT_EQ(min_heap_assign(&heap, values, 3), 0);
+    ASSERT_EQ(min_heap_save(&heap, path), 0);
+    auto corrupt_byte = [&](long offset, int whence) {
+        FILE* f = std::fopen(path, "r+b");
+        ASSERT_TRUE(f != nullptr);
+        std::fseek(f, offset, whence);
+        std::fputc(0x7f, f);
+        std::fclose(f);
+    };
+    // A damaged payload is only caught by the opt-in full verification.
+    corrupt_byte(-1, SEEK_END);
+    EXPECT_EQ(min_heap_load_mmap(&loaded, path, MIN_HEAP_LOAD_VERIFY), -1);
+    ASSERT_EQ(min_heap_load_mmap(&loaded, path, 0), 0);
+    EXPECT_EQ(loaded.size, 3);
+    min_heap_destroy(&loaded);
+    // A damaged header (here the stored payload checksum) always is.
+    ASSERT_EQ(min_heap_save(&heap, path), 0);
+    corrupt_byte(24, SEEK_SET);
+    EXPECT_EQ(min_heap_load_mmap(&loaded, path, 0), -1);
+    EXPECT_EQ(min_heap_load_mmap(&loaded, missing.c_str(), 0), -1);
+    min_heap_destroy(&heap);
+}
+
+TEST(Calculator, VmArenaGrowsHeapInPlace) {
+    min_heap_vm_arena_t arena;
+    ASSERT_EQ(min_heap_vm_arena_init(&arena, 1 << 20, MIN_HEAP_VM_THP, -1), 0);
+    min_heap_t heap;
+    ASSERT_EQ(min_heap_init(&heap, 16, &arena.allocator), 0);
+    int* const base = heap.data;
+    const int limit = static_cast<int>(arena.reserved / sizeof(int));
+    for (int i = 0; i < limit; ++i) {
+        ASSERT_EQ(min_heap_push(&heap, limit - i), 0);
+    }
+    EXPECT_TRUE(heap.data == base);
+    int value = 0;
+    EXPECT_EQ(min_heap_peek(&heap, &value), 0);
+    EXPECT_EQ(value, 1);
+    // The reservation is a hard cap; the heap is left intact.
+    EXPECT_EQ(min_heap_push(&heap, 0), -1);
+    EXPECT_EQ(heap.size, limit);
+
+    // One heap per arena at a time.
+    min_heap_t other;
+    EXPECT_EQ(min_heap_init(&other, 16, &arena.allocator), -1);
+    EXPECT_EQ(min_heap_shrink_to_fit(&heap), 0);
+    EXPECT_TRUE(heap.data == base);
+    min_heap_destroy(&heap);
+    EXPECT_EQ(arena.committed, 0u);
+    EXPECT_EQ(min_heap_init(&other, 16, &arena.allocator), 0);
+    min_heap_destroy(&other);
+    min_heap_vm_arena_destroy(&arena);
+}
+
+TEST(Calculator, VmArenaFillsReservationNotOnGrowthBoundary) {
+    // 6 MiB holds 1572864 ints: neither 10 (the default start) nor 16 doubles
+    // onto that, so the last growth step must fall back to the exact size.
+    for (int start : {0, 16}) {
+        min_heap_vm_arena_t arena;
+        ASSERT_EQ(min_heap_vm_arena_init(&arena, 3 << 21, 0, -1), 0);
+        const int limit = static_cast<int>(arena.reserved / sizeof(int));
+        ASSERT_EQ(limit, 1572864);
+        min_heap_t heap;
+        ASSERT_EQ(min_heap_init(&heap, start, &arena.allocator), 0);
+        for (int i = 0; i < limit; ++i) {
+            ASSERT_EQ(min_heap_push(&heap, i), 0);
+        }
+        EXPECT_EQ(heap.capacity, limit);
+        EXPECT_EQ(min_heap_push(&heap, -1), -1);
+        EXPECT_EQ(heap.size, limit);
+        int value = -1;
+        EXPECT_EQ(min_heap_peek(&heap, &value), 0);
+        EXPECT_EQ(value, 0);
+        min_heap_destroy(&heap);
+        min_heap_vm_arena_destroy(&arena);
+    }
+}
+
+TEST(Calculator, VmArenaHugePagesFallBack) {
+    min_heap_vm_arena_t arena;
+    ASSERT_EQ(min_heap_vm_arena_init(&arena, 4 << 20, MIN_HEAP_VM_HUGETLB, -1), 0);
+    EXPECT_TRUE(arena.page_size >= 4096u);
+    min_heap_t heap;
+    ASSERT_EQ(min_heap_init(&heap, 0, &arena.allocator), 0);
+    for (int i = 0; i < 100000; ++i) ASSERT_EQ(min_heap_push(&heap, i ^ 0x5555), 0);
+    int out[3];
+    EXPECT_EQ(min_heap_pop_n(&heap, out, 3), 3);
+    EXPECT_TRUE(out[0] <= out[1] && out[1] <= out[2]);
+    min_heap_destroy(&heap);
+    min_heap_vm_arena_destroy(&arena);
+}
+
 TEST(Calculator, AddsNumbers) {
     EXPECT_EQ(add(2, 3), 5);
     EXPECT_EQ(add(-1, 1), 0);
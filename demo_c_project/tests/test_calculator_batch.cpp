@@ -0,0 +1,139 @@
+#include <climits>
+#include <cstdlib>
+#include <vector>
+#include "calculator.h"
+#include "cpu_features.h"
+#include "gtest.h"
+
+namespace {
+std::vector<int> RandomColumn(size_t n) {
+    std::vector<int> column(n);
+    for (auto& v : column) v = rand() - RAND_MAX / 2;
+    return column;
+}
+
+int WrapAdd(int a, int b) { return static_cast<int>(static_cast<unsigned>(a) + static_cast<unsigned>(b)); }
+int WrapSub(int a, int b) { return static_cast<int>(static_cast<unsigned>(a) - static_cast<unsigned>(b)); }
+int WrapMul(int a, int b) { return static_cast<int>(static_cast<unsigned>(a) * static_cast<unsigned>(b)); }
+
+const unsigned kFeatureMasks[] = {0u, CPU_FEATURE_AVX2 | CPU_FEATURE_NEON, ~0u};
+}  // namespace
+
+TEST(CalculatorBatch, ArrayKernelsMatchScalarOnEveryPath) {
+    for (unsigned mask : kFeatureMasks) {
+        cpu_features_set_mask(mask);
+        for (size_t n : {0u, 1u, 7u, 8u, 15u, 16u, 17u, 33u, 1000u}) {
+            std::vector<int> a = RandomColumn(n);
+            std::vector<int> b = RandomColumn(n);
+            std::vector<int> sum(n), diff(n), prod(n);
+            add_n(a.data(), b.data(), sum.data(), n);
+            subtract_n(a.data(), b.data(), diff.data(), n);
+            multiply_n(a.data(), b.data(), prod.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                EXPECT_EQ(sum[i], WrapAdd(a[i], b[i]));
+                EXPECT_EQ(diff[i], WrapSub(a[i], b[i]));
+                EXPECT_EQ(prod[i], WrapMul(a[i], b[i]));
+            }
+        }
+    }
+    cpu_features_set_mask(~0u);
+}
+
+TEST(CalculatorBatch, InPlaceAndBroadcastVariants) {
+    for (unsigned mask : kFeatureMasks) {
+        cpu_features_set_mask(mask);
+        const size_t n = 37;
+        std::vector<int> a = RandomColumn(n);
+        std::vector<int> b = RandomColumn(n);
+        std::vector<int> acc = a;
+        add_inplace_n(acc.data(), b.data(), n);
+        multiply_inplace_n(acc.data(), b.data(), n);
+        subtract_inplace_n(acc.data(), a.data(), n);
+        std::vector<int> out(n);
+        add_scalar_n(a.data(), INT_MAX, out.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_EQ(acc[i], WrapSub(WrapMul(WrapAdd(a[i], b[i]), b[i]), a[i]));
+            EXPECT_EQ(out[i], WrapAdd(a[i], INT_MAX));
+        }
+        subtract_scalar_n(a.data(), 5, out.data(), n);
+        EXPECT_EQ(out[n - 1], WrapSub(a[n - 1], 5));
+        std::vector<int> scaled = a;
+        multiply_scalar_n(scaled.data(), -3, scaled.data(), n);
+        for (size_t i = 0; i < n; ++i) EXPECT_EQ(scaled[i], WrapMul(a[i], -3));
+    }
+    cpu_features_set_mask(~0u);
+}
+
+TEST(CalculatorBatch, ArrayKernelsAgreeWithScalarPrimitives) {
+    const int a[] = {2, -1, 6, 0};
+    const int b[] = {3, 1, 3, 9};
+    int out[4];
+    add_n(a, b, out, 4);
+    for (int i = 0; i < 4; ++i) EXPECT_EQ(out[i], add(a[i], b[i]));
+    subtract_n(a, b, out, 4);
+    for (int i = 0; i < 4; ++i) EXPECT_EQ(out[i], subtract(a[i], b[i]));
+    multiply_n(a, b, out, 4);
+    for (int i = 0; i < 4; ++i) EXPECT_EQ(out[i], multiply(a[i], b[i]));
+}
+
+TEST(CalculatorBatch, PreparedDivisorMatchesHardwareDivision) {
+    const int divisors[] = {1, -1, 2, -2, 3, 7, -7, 10, 641, 65536, -65536, 1000000007, INT_MAX, INT_MIN, INT_MIN + 1};
+    std::vector<int> a = RandomColumn(501);
+    a[0] = 0;
+    a[1] = INT_MAX;
+    a[2] = INT_MIN;
+    a[3] = INT_MIN + 1;
+    a[4] = -1;
+    for (unsigned mask : kFeatureMasks) {
+        cpu_features_set_mask(mask);
+        for (int d : divisors) {
+            calc_divisor_t prepared;
+            ASSERT_EQ(calc_divisor_prepare(&prepared, d), 0);
+            std::vector<int> q(a.size()), r(a.size());
+            EXPECT_EQ(divide_prepared_n(a.data(), &prepared, q.data(), a.size()), 0);
+            EXPECT_EQ(mod_scalar_n(a.data(), d, r.data(), a.size()), 0);
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (a[i] == INT_MIN && d == -1) {
+                    EXPECT_EQ(q[i], INT_MIN);
+                    EXPECT_EQ(r[i], 0);
+                    continue;
+                }
+                int err = 0;
+                EXPECT_EQ(q[i], divide(a[i], d, &err));
+                EXPECT_EQ(r[i], calculator_mod(a[i], d, &err));
+                EXPECT_EQ(calc_divisor_divide(&prepared, a[i]), q[i]);
+            }
+        }
+    }
+    cpu_features_set_mask(~0u);
+}
+
+TEST(CalculatorBatch, DivideByZeroIsReportedPerBatch) {
+    const int a[] = {5, -8, 13};
+    int out[3] = {1, 1, 1};
+    EXPECT_EQ(divide_scalar_n(a, 0, out, 3), 1);
+    EXPECT_EQ(out[0] + out[1] + out[2], 0);
+    EXPECT_EQ(mod_scalar_n(a, 0, out, 3), 1);
+    EXPECT_EQ(divide_scalar_n(a, 4, out, 3), 0);
+    EXPECT_EQ(out[1], -2);
+}
+
+TEST(CalculatorBatch, PerElementDivisorsSetErrorBitmap) {
+    const int a[] = {9, 9, INT_MIN, 7, 1, 2, 3, 4, 100};
+    const int b[] = {3, 0, -1, -2, 0, 1, 1, 1, 0};
+    int q[9];
+    int r[9];
+    unsigned char bits[2] = {0xff, 0xff};
+    EXPECT_EQ(divide_n(a, b, q, bits, 9), 1);
+    EXPECT_EQ(bits[0], 0x12);
+    EXPECT_EQ(bits[1], 0x01);
+    EXPECT_EQ(q[0], 3);
+    EXPECT_EQ(q[1], 0);
+    EXPECT_EQ(q[2], INT_MIN);
+    EXPECT_EQ(q[3], -3);
+    EXPECT_EQ(mod_n(a, b, r, nullptr, 9), 1);
+    EXPECT_EQ(r[2], 0);
+    EXPECT_EQ(r[3], 1);
+    const int ok_b[] = {1, 2, 3};
+    EXPECT_EQ(divide_n(a, ok_b, q, nullptr, 3), 0);
+}
@@ -0,0 +1,141 @@
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "calculator.h"
+#include "gtest.h"
+
+namespace {
+int Clamp(int64_t v) {
+    return v > INT_MAX ? INT_MAX : v < INT_MIN ? INT_MIN : static_cast<int>(v);
+}
+
+bool Fits(int64_t v) {
+    return v >= INT_MIN && v <= INT_MAX;
+}
+}  // namespace
+
+TEST(CalculatorChecked, ScalarCheckedReportsOverflow) {
+    int overflow = -1;
+    EXPECT_EQ(add_checked(2, 3, &overflow), 5);
+    EXPECT_EQ(overflow, 0);
+    EXPECT_EQ(add_checked(INT_MAX, 1, &overflow), INT_MIN);
+    EXPECT_EQ(overflow, 1);
+    EXPECT_EQ(subtract_checked(INT_MIN, 1, &overflow), INT_MAX);
+    EXPECT_EQ(overflow, 1);
+    EXPECT_EQ(multiply_checked(1 << 16, 1 << 16, &overflow), 0);
+    EXPECT_EQ(overflow, 1);
+    EXPECT_EQ(multiply_checked(-46340, 46340, &overflow), -46340 * 46340);
+    EXPECT_EQ(overflow, 0);
+    int err = -1;
+    EXPECT_EQ(divide_checked(INT_MIN, -1, &err, &overflow), INT_MIN);
+    EXPECT_EQ(err, 0);
+    EXPECT_EQ(overflow, 1);
+    EXPECT_EQ(divide_checked(7, 0, &err, &overflow), 0);
+    EXPECT_EQ(err, 1);
+    EXPECT_EQ(overflow, 0);
+}
+
+TEST(CalculatorChecked, ScalarSaturates) {
+    EXPECT_EQ(add_sat(INT_MAX, 5), INT_MAX);
+    EXPECT_EQ(add_sat(INT_MIN, -5), INT_MIN);
+    EXPECT_EQ(add_sat(-5, 3), -2);
+    EXPECT_EQ(subtract_sat(INT_MIN, 1), INT_MIN);
+    EXPECT_EQ(subtract_sat(INT_MAX, -1), INT_MAX);
+    EXPECT_EQ(multiply_sat(INT_MIN, -1), INT_MAX);
+    EXPECT_EQ(multiply_sat(INT_MAX, -2), INT_MIN);
+    EXPECT_EQ(multiply_sat(-7, 6), -42);
+    int err = -1;
+    EXPECT_EQ(divide_sat(INT_MIN, -1, &err), INT_MAX);
+    EXPECT_EQ(err, 0);
+}
+
+TEST(CalculatorChecked, ArrayFormsMatchWideArithmetic) {
+    const size_t n = 1000;
+    std::vector<int> a(n), b(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = static_cast<int>(static_cast<unsigned>(rand()) * 2654435761u);
+        b[i] = static_cast<int>(static_cast<unsigned>(rand()) * 2246822519u) >> (rand() % 24);
+    }
+    a[0] = INT_MIN;
+    b[0] = -1;
+    std::vector<int> wrapped(n), sat(n);
+    bool any_add = false, any_sub = false, any_mul = false;
+    int add_flag = add_checked_n(a.data(), b.data(), wrapped.data(), n);
+    int add_sat_flag = add_sat_n(a.data(), b.data(), sat.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+        int64_t wide = static_cast<int64_t>(a[i]) + b[i];
+        any_add |= !Fits(wide);
+        EXPECT_EQ(wrapped[i], static_cast<int>(static_cast<uint32_t>(wide)));
+        EXPECT_EQ(sat[i], Clamp(wide));
+    }
+    int sub_flag = subtract_checked_n(a.data(), b.data(), wrapped.data(), n);
+    int sub_sat_flag = subtract_sat_n(a.data(), b.data(), sat.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+        int64_t wide = static_cast<int64_t>(a[i]) - b[i];
+        any_sub |= !Fits(wide);
+        EXPECT_EQ(wrapped[i], static_cast<int>(static_cast<uint32_t>(wide)));
+        EXPECT_EQ(sat[i], Clamp(wide));
+    }
+    int mul_flag = multiply_checked_n(a.data(), b.data(), wrapped.data(), n);
+    int mul_sat_flag = multiply_sat_n(a.data(), b.data(), sat.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+        int64_t wide = static_cast<int64_t>(a[i]) * b[i];
+        any_mul |= !Fits(wide);
+        EXPECT_EQ(wrapped[i], static_cast<int>(static_cast<uint32_t>(wide)));
+        EXPECT_EQ(sat[i], Clamp(wide));
+    }
+    EXPECT_EQ(add_flag, any_add ? 1 : 0);
+    EXPECT_EQ(add_sat_flag, add_flag);
+    EXPECT_EQ(sub_flag, any_sub ? 1 : 0);
+    EXPECT_EQ(sub_sat_flag, sub_flag);
+    EXPECT_EQ(mul_flag, any_mul ? 1 : 0);
+    EXPECT_EQ(mul_sat_flag, mul_flag);
+}
+
+TEST(CalculatorChecked, ArrayFlagStaysClearWithoutOverflow) {
+    const int a[] = {1, -2, 3, 1000};
+    const int b[] = {4, 5, -6, 1000};
+    int out[4];
+    EXPECT_EQ(add_checked_n(a, b, out, 4), 0);
+    EXPECT_EQ(subtract_sat_n(a, b, out, 4), 0);
+    EXPECT_EQ(multiply_checked_n(a, b, out, 4), 0);
+    EXPECT_EQ(out[3], 1000000);
+}
+
+TEST(CalculatorChecked, DivideCheckedArrayFlagsIntMinOverMinusOne) {
+    const int a[] = {INT_MIN, 7, INT_MIN, -9, 12};
+    const int b[] = {-1, 0, 2, -1, 5};
+    int out[5];
+    int expected[5];
+    unsigned char bits = 0xee, expected_bits = 0;
+    int err = -1;
+    divide_n(a, b, expected, &expected_bits, 5);
+    EXPECT_EQ(divide_checked_n(a, b, out, &bits, &err, 5), 1);
+    EXPECT_EQ(err, 1);
+    EXPECT_EQ(bits, expected_bits);
+    EXPECT_EQ(bits, 0x02);
+    for (int i = 0; i < 5; ++i) EXPECT_EQ(out[i], expected[i]);
+    EXPECT_EQ(out[0], INT_MIN);
+
+    mod_n(a, b, expected, &expected_bits, 5);
+    EXPECT_EQ(mod_checked_n(a, b, out, nullptr, &err, 5), 1);
+    EXPECT_EQ(err, 1);
+    for (int i = 0; i < 5; ++i) EXPECT_EQ(out[i], expected[i]);
+    EXPECT_EQ(out[0], 0);
+
+    EXPECT_EQ(divide_sat_n(a, b, out, &bits, &err, 5), 1);
+    EXPECT_EQ(err, 1);
+    EXPECT_EQ(bits, 0x02);
+    EXPECT_EQ(out[0], INT_MAX);
+    for (int i = 0; i < 5; ++i) EXPECT_EQ(out[i], b[i] == 0 ? 0 : divide_sat(a[i], b[i], nullptr));
+
+    // Without INT_MIN / -1 or a zero divisor both flags stay clear.
+    EXPECT_EQ(divide_checked_n(a + 2, b + 2, out, nullptr, &err, 3), 0);
+    EXPECT_EQ(err, 0);
+    EXPECT_EQ(divide_sat_n(a + 2, b + 2, out, nullptr, nullptr, 3), 0);
+    EXPECT_EQ(out[1], 9);
+    EXPECT_EQ(mod_checked_n(a + 3, b + 3, out, nullptr, nullptr, 2), 0);
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(out[1], 2);
+}
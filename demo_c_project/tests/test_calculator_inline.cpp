@@ -0,0 +1,39 @@
+#define CALCULATOR_INLINE
+#include <cstdlib>
+#include <vector>
+#include "calculator.h"
+#include "gtest.h"
+
+TEST(CalculatorInline, ScalarPrimitivesMatchOutOfLineSemantics) {
+    EXPECT_EQ(add(2, 3), 5);
+    EXPECT_EQ(subtract(2, 7), -5);
+    EXPECT_EQ(multiply(-6, 7), -42);
+    int err = -1;
+    EXPECT_EQ(divide(-7, 2, &err), -3);
+    EXPECT_EQ(err, 0);
+    EXPECT_EQ(divide(7, 0, &err), 0);
+    EXPECT_EQ(err, 1);
+    EXPECT_EQ(calculator_mod(-7, 3, &err), -1);
+    EXPECT_EQ(err, 0);
+    EXPECT_EQ(calculator_mod(7, 0, &err), 0);
+    EXPECT_EQ(err, 1);
+    EXPECT_EQ(divide(7, 0, nullptr), 0);
+}
+
+TEST(CalculatorInline, InlinedLoopsMatchArrayKernels) {
+    const size_t n = 1003;
+    std::vector<int> a(n), b(n), expected(n), out(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = rand() % 20000 - 10000;
+        b[i] = rand() % 20000 - 10000;
+    }
+    add_n(a.data(), b.data(), expected.data(), n);
+    for (size_t i = 0; i < n; ++i) out[i] = add(a[i], b[i]);
+    EXPECT_TRUE(out == expected);
+    multiply_n(a.data(), b.data(), expected.data(), n);
+    for (size_t i = 0; i < n; ++i) out[i] = multiply(a[i], b[i]);
+    EXPECT_TRUE(out == expected);
+    subtract_n(a.data(), b.data(), expected.data(), n);
+    for (size_t i = 0; i < n; ++i) out[i] = subtract(a[i], b[i]);
+    EXPECT_TRUE(out == expected);
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+#include "cpu_features.h"
+#include "dary_heap.h"
+#include "dary_heap.hpp"
+#include "gtest.h"
+
+TEST(DaryHeap, FourAryDrainsInOrder) {
+    int* heap = nullptr;
+    int size = 0;
+    int capacity = 0;
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(rand() % 10000);
+        dary4_heap_insert(&heap, &size, &capacity, values.back());
+    }
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(dary4_heap_peek_min(heap, size), values[0]);
+    std::vector<int> drained;
+    while (size > 0) {
+        drained.push_back(dary4_heap_delete_min(&heap, &size));
+    }
+    EXPECT_TRUE(drained == values);
+    EXPECT_EQ(dary4_heap_delete_min(&heap, &size), -1);
+    EXPECT_EQ(dary4_heap_peek_min(heap, size), -1);
+    dary4_destroy_queue(&heap, &size, &capacity);
+    EXPECT_TRUE(heap == nullptr);
+    EXPECT_EQ(capacity, 0);
+}
+
+TEST(DaryHeap, EightAryDrainsInOrder) {
+    int* heap = nullptr;
+    int size = 0;
+    int capacity = 0;
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(rand() % 10000);
+        dary8_heap_insert(&heap, &size, &capacity, values.back());
+    }
+    std::sort(values.begin(), values.end());
+    std::vector<int> drained;
+    while (size > 0) {
+        drained.push_back(dary8_heap_delete_min(&heap, &size));
+    }
+    EXPECT_TRUE(drained == values);
+    dary8_destroy_queue(&heap, &size, &capacity);
+}
+
+TEST(DaryHeap, TemplateSupportsCustomComparator) {
+    dary_heap<double, 3, std::greater<double>> heap;
+    const double values[] = {1.5, -2.0, 8.25, 3.0, 8.0, 0.0, 2.5};
+    for (double v : values) heap.push(v);
+    ASSERT_EQ(heap.size(), 7u);
+    std::vector<double> drained;
+    while (!heap.empty()) {
+        drained.push_back(heap.top());
+        heap.pop();
+    }
+    EXPECT_TRUE(std::is_sorted(drained.begin(), drained.end(), std::greater<double>()));
+    EXPECT_EQ(drained.front(), 8.25);
+}
+
+TEST(DaryHeap, HeapifiesRawArray) {
+    std::vector<int> values;
+    for (int i = 0; i < 997; ++i) values.push_back(rand() % 100);
+    dary_heap<int, 4>::heapify(values.data(), values.size(), std::less<int>());
+    for (size_t i = 1; i < values.size(); ++i) {
+        EXPECT_TRUE(values[(i - 1) / 4] <= values[i]);
+    }
+}
+
+static std::vector<int> DrainWithFeatures(unsigned mask, bool eight_ary, const std::vector<int>& values) {
+    cpu_features_set_mask(mask);
+    int* heap = nullptr;
+    int size = 0;
+    int capacity = 0;
+    for (int v : values) {
+        if (eight_ary) {
+            dary8_heap_insert(&heap, &size, &capacity, v);
+        } else {
+            dary4_heap_insert(&heap, &size, &capacity, v);
+        }
+    }
+    std::vector<int> drained(values.size());
+    int popped = eight_ary ? dary8_heap_delete_min_n(&heap, &size, drained.data(), size)
+                           : dary4_heap_delete_min_n(&heap, &size, drained.data(), size);
+    drained.resize(popped);
+    dary4_destroy_queue(&heap, &size, &capacity);
+    cpu_features_set_mask(~0u);
+    return drained;
+}
+
+TEST(DaryHeap, SimdAndScalarKernelsAgree) {
+    std::vector<int> values;
+    for (int i = 0; i < 2000; ++i) values.push_back(rand() % 50 - 25);
+    std::vector<int> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    for (bool eight_ary : {false, true}) {
+        EXPECT_TRUE(DrainWithFeatures(0, eight_ary, values) == sorted);
+        EXPECT_TRUE(DrainWithFeatures(CPU_FEATURE_SSE41 | CPU_FEATURE_NEON, eight_ary, values) == sorted);
+        EXPECT_TRUE(DrainWithFeatures(~0u, eight_ary, values) == sorted);
+    }
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "gtest.h"
+#include "heap_merge.h"
+#if defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::vector<int> random_values(std::size_t n) {
+    std::mt19937 rng(testing::GetRandomSeed());
+    std::vector<int> values(n);
+    for (int& v : values) v = static_cast<int>(rng());
+    return values;
+}
+
+int collect(void* ctx, const int* values, size_t n) {
+    auto* out = static_cast<std::vector<int>*>(ctx);
+    out->insert(out->end(), values, values + n);
+    return 0;
+}
+
+int stop_after_first_block(void* ctx, const int*, size_t) {
+    return ++*static_cast<int*>(ctx) > 1;
+}
+
+}  // namespace
+
+TEST(HeapMerge, ParallelSortMatchesStdSort) {
+    for (int threads : {1, 3, 4, 0}) {
+        std::vector<int> values = random_values(100003);
+        std::vector<int> expected = values;
+        std::sort(expected.begin(), expected.end());
+        ASSERT_EQ(heap_parallel_sort(values.data(), values.size(), threads), 0);
+        EXPECT_TRUE(values == expected);
+    }
+    int one = 5;
+    EXPECT_EQ(heap_parallel_sort(&one, 1, 4), 0);
+    EXPECT_EQ(heap_parallel_sort(nullptr, 0, 4), 0);
+    int few[] = {3, 1, 2};
+    EXPECT_EQ(heap_parallel_sort(few, 3, 8), 0);
+    EXPECT_TRUE(few[0] == 1 && few[1] == 2 && few[2] == 3);
+}
+
+TEST(HeapMerge, MergesRunsIntoSink) {
+    const int a[] = {1, 4, 9};
+    const int b[] = {2, 3, 10, 11};
+    const int c[] = {4};
+    const int* runs[] = {a, b, c, nullptr};
+    const size_t lengths[] = {3, 4, 1, 0};
+    std::vector<int> out;
+    ASSERT_EQ(heap_merge_runs(runs, lengths, 4, collect, &out), 0);
+    EXPECT_TRUE(out == (std::vector<int>{1, 2, 3, 4, 4, 9, 10, 11}));
+
+    std::vector<int> big = random_values(20000);
+    std::sort(big.begin(), big.end());
+    const int* one_run[] = {big.data()};
+    const size_t one_len[] = {big.size()};
+    int calls = 0;
+    EXPECT_EQ(heap_merge_runs(one_run, one_len, 1, stop_after_first_block, &calls), -1);
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(HeapMerge, ExternalSortSpillsRunsWithinBudget) {
+    std::vector<int> values = random_values(50000);
+    FILE* in = std::tmpfile();
+    FILE* out = std::tmpfile();
+    ASSERT_TRUE(in != nullptr && out != nullptr);
+    ASSERT_EQ(std::fwrite(values.data(), sizeof(int), values.size(), in), values.size());
+    std::rewind(in);
+    // 16 KiB budget: 2048-value runs, so 25 spilled runs are merged.
+    ASSERT_EQ(heap_external_sort(in, out, 16 << 10, 2), 0);
+    std::rewind(out);
+    std::vector<int> sorted(values.size() + 1);
+    EXPECT_EQ(std::fread(sorted.data(), sizeof(int), sorted.size(), out), values.size());
+    sorted.pop_back();
+    std::sort(values.begin(), values.end());
+    EXPECT_TRUE(sorted == values);
+    std::fclose(in);
+    std::fclose(out);
+}
+
+TEST(HeapMerge, MergeFilesFailsOnUnreadableRun) {
+    const int values[] = {1, 5, 8};
+    FILE* good = std::tmpfile();
+    ASSERT_TRUE(good != nullptr);
+    ASSERT_EQ(std::fwrite(values, sizeof(int), 3, good), 3u);
+    std::rewind(good);
+    std::vector<int> out;
+    FILE* one[] = {good};
+    ASSERT_EQ(heap_merge_files(one, 1, 0, collect, &out), 0);
+    EXPECT_TRUE(out == (std::vector<int>{1, 5, 8}));
+
+    // A write-only stream fails its very first read, before the run has
+    // produced a head value.
+    const std::string path = "heap_merge_write_only_" + std::to_string(getpid()) + ".bin";
+    FILE* bad = std::fopen(path.c_str(), "wb");
+    ASSERT_TRUE(bad != nullptr);
+    std::rewind(good);
+    out.clear();
+    FILE* both[] = {good, bad};
+    EXPECT_EQ(heap_merge_files(both, 2, 0, collect, &out), -1);
+    std::fclose(bad);
+    std::remove(path.c_str());
+    std::fclose(good);
+}
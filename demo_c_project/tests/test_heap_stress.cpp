@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include "calculator.h"
+#include "dary_heap.h"
+#include "gtest.h"
+
+namespace {
+
+enum class Pattern { Random, Duplicates, Sorted, Reverse, Sawtooth };
+
+struct StressCase {
+    Pattern pattern;
+    size_t size;
+};
+
+const char* PatternName(Pattern p) {
+    switch (p) {
+    case Pattern::Random: return "random";
+    case Pattern::Duplicates: return "duplicates";
+    case Pattern::Sorted: return "sorted";
+    case Pattern::Reverse: return "reverse";
+    default: return "sawtooth";
+    }
+}
+
+// Sizes run by default stay quick in a debug build; HEAP_STRESS_MAX_SIZE=1e7
+// adds the large cases.
+std::vector<StressCase> StressCases() {
+    const char* env = std::getenv("HEAP_STRESS_MAX_SIZE");
+    size_t max_size = env ? static_cast<size_t>(std::strtod(env, nullptr)) : 100000;
+    std::vector<StressCase> cases;
+    for (size_t size = 1000; size <= max_size && size <= 10000000; size *= 100) {
+        for (Pattern p : {Pattern::Random, Pattern::Duplicates, Pattern::Sorted, Pattern::Reverse, Pattern::Sawtooth}) {
+            cases.push_back(StressCase{p, size});
+        }
+    }
+    return cases;
+}
+
+std::string CaseName(const testing::TestParamInfo<StressCase>& info) {
+    return std::string(PatternName(info.param.pattern)) + "_" + std::to_string(info.param.size);
+}
+
+std::vector<int> MakeInput(const StressCase& c, std::mt19937& rng) {
+    std::vector<int> values(c.size);
+    std::uniform_int_distribution<int> any(-1000000000, 1000000000);
+    std::uniform_int_distribution<int> few(0, 15);
+    for (size_t i = 0; i < c.size; ++i) {
+        switch (c.pattern) {
+        case Pattern::Random: values[i] = any(rng); break;
+        case Pattern::Duplicates: values[i] = few(rng); break;
+        case Pattern::Sorted: values[i] = static_cast<int>(i); break;
+        case Pattern::Reverse: values[i] = static_cast<int>(c.size - i); break;
+        case Pattern::Sawtooth: values[i] = static_cast<int>(i % 97); break;
+        }
+    }
+    return values;
+}
+
+// Times `body` and records the cost per heap operation as a test property.
+void RecordNsPerOp(size_t ops, const std::function<void()>& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    testing::RecordProperty("ns_per_op", elapsed.count() / static_cast<double>(ops ? ops : 1));
+}
+
+class HeapStress : public testing::TestWithParam<StressCase> {};
+
+}  // namespace
+
+TEST_P(HeapStress, PushThenPopMatchesSortedInput) {
+    std::mt19937 rng(testing::GetRandomSeed());
+    std::vector<int> input = MakeInput(GetParam(), rng);
+    std::vector<int> popped;
+    popped.reserve(input.size());
+    min_heap_t heap;
+    ASSERT_EQ(min_heap_init(&heap, 0, nullptr), 0);
+    RecordNsPerOp(2 * input.size(), [&] {
+        for (int v : input) min_heap_push(&heap, v);
+        int out;
+        while (min_heap_pop(&heap, &out) == 0) popped.push_back(out);
+    });
+    min_heap_destroy(&heap);
+    std::sort(input.begin(), input.end());
+    EXPECT_TRUE(popped == input);
+}
+
+TEST_P(HeapStress, BulkBuildThenDrainMatchesSortedInput) {
+    std::mt19937 rng(testing::GetRandomSeed());
+    std::vector<int> input = MakeInput(GetParam(), rng);
+    std::vector<int> popped(input.size());
+    int* heap = nullptr;
+    int size = 0, capacity = 0;
+    RecordNsPerOp(input.size(), [&] {
+        min_heap_build(&heap, &size, &capacity, input.data(), static_cast<int>(input.size()));
+        min_heap_delete_min_n(&heap, &size, popped.data(), static_cast<int>(popped.size()));
+    });
+    EXPECT_EQ(size, 0);
+    destroy_queue(&heap, &size, &capacity);
+    std::sort(input.begin(), input.end());
+    EXPECT_TRUE(popped == input);
+}
+
+TEST_P(HeapStress, InterleavedPushPopMatchesReference) {
+    std::mt19937 rng(testing::GetRandomSeed());
+    std::vector<int> input = MakeInput(GetParam(), rng);
+    // Pops drawn with probability 1/3, so the heap keeps growing while it
+    // churns; the reference is std::priority_queue.
+    std::vector<char> pop_here(input.size());
+    for (auto& p : pop_here) p = rng() % 3 == 0;
+    std::vector<int> popped, expected;
+    min_heap_t heap;
+    ASSERT_EQ(min_heap_init(&heap, 0, nullptr), 0);
+    RecordNsPerOp(input.size(), [&] {
+        int out;
+        for (size_t i = 0; i < input.size(); ++i) {
+            if (pop_here[i] && min_heap_pop(&heap, &out) == 0) popped.push_back(out);
+            min_heap_push(&heap, input[i]);
+        }
+    });
+    min_heap_destroy(&heap);
+    std::priority_queue<int, std::vector<int>, std::greater<int>> reference;
+    for (size_t i = 0; i < input.size(); ++i) {
+        if (pop_here[i] && !reference.empty()) {
+            expected.push_back(reference.top());
+            reference.pop();
+        }
+        reference.push(input[i]);
+    }
+    EXPECT_TRUE(popped == expected);
+}
+
+TEST_P(HeapStress, DaryHeapsDrainInOrder) {
+    std::mt19937 rng(testing::GetRandomSeed());
+    std::vector<int> input = MakeInput(GetParam(), rng);
+    std::vector<int> d4, d8;
+    int* h4 = nullptr;
+    int* h8 = nullptr;
+    int s4 = 0, c4 = 0, s8 = 0, c8 = 0;
+    RecordNsPerOp(4 * input.size(), [&] {
+        for (int v : input) {
+            dary4_heap_insert(&h4, &s4, &c4, v);
+            dary8_heap_insert(&h8, &s8, &c8, v);
+        }
+        while (s4 > 0) d4.push_back(dary4_heap_delete_min(&h4, &s4));
+        while (s8 > 0) d8.push_back(dary8_heap_delete_min(&h8, &s8));
+    });
+    dary4_destroy_queue(&h4, &s4, &c4);
+    dary8_destroy_queue(&h8, &s8, &c8);
+    std::sort(input.begin(), input.end());
+    EXPECT_TRUE(d4 == input);
+    EXPECT_TRUE(d8 == input);
+}
+
+INSTANTIATE_TEST_SUITE_P(Inputs, HeapStress, testing::ValuesIn(StressCases()), CaseName);
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <vector>
+#include "gtest.h"
+#include "indexed_heap.h"
+
+TEST(IndexedHeap, DecreaseKeyReordersElements) {
+    indexed_heap_t heap;
+    ASSERT_EQ(indexed_heap_init(&heap, 0), 0);
+    int a = indexed_heap_push(&heap, 50);
+    int b = indexed_heap_push(&heap, 20);
+    int c = indexed_heap_push(&heap, 30);
+    ASSERT_TRUE(a >= 0 && b >= 0 && c >= 0);
+    EXPECT_EQ(indexed_heap_decrease_key(&heap, a, 10), 0);
+    EXPECT_EQ(indexed_heap_decrease_key(&heap, c, 40), -1);
+    int key = 0;
+    int handle = -1;
+    ASSERT_EQ(indexed_heap_pop(&heap, &key, &handle), 0);
+    EXPECT_EQ(key, 10);
+    EXPECT_EQ(handle, a);
+    EXPECT_FALSE(indexed_heap_contains(&heap, a));
+    EXPECT_EQ(indexed_heap_decrease_key(&heap, a, 0), -1);
+    ASSERT_EQ(indexed_heap_pop(&heap, &key, &handle), 0);
+    EXPECT_EQ(handle, b);
+    indexed_heap_destroy(&heap);
+}
+
+TEST(IndexedHeap, RandomOperationsMatchReference) {
+    indexed_heap_t heap;
+    ASSERT_EQ(indexed_heap_init(&heap, 0), 0);
+    std::map<int, int> reference;  // handle -> key
+    for (int step = 0; step < 5000; ++step) {
+        int op = rand() % 4;
+        if (op == 0 || reference.empty()) {
+            int key = rand() % 1000;
+            int handle = indexed_heap_push(&heap, key);
+            ASSERT_TRUE(handle >= 0);
+            ASSERT_TRUE(reference.count(handle) == 0);
+            reference[handle] = key;
+        } else {
+            auto it = reference.begin();
+            std::advance(it, rand() % reference.size());
+            if (op == 1) {
+                int new_key = it->second - rand() % 100;
+                ASSERT_EQ(indexed_heap_decrease_key(&heap, it->first, new_key), 0);
+                it->second = new_key;
+            } else if (op == 2) {
+                ASSERT_EQ(indexed_heap_remove(&heap, it->first), 0);
+                reference.erase(it);
+            } else {
+                int key = 0;
+                int handle = -1;
+                ASSERT_EQ(indexed_heap_pop(&heap, &key, &handle), 0);
+                int expected = reference.begin()->second;
+                for (const auto& [h, k] : reference) expected = std::min(expected, k);
+                EXPECT_EQ(key, expected);
+                EXPECT_EQ(reference[handle], key);
+                reference.erase(handle);
+            }
+        }
+        ASSERT_EQ(heap.size, static_cast<int>(reference.size()));
+    }
+    for (const auto& [h, k] : reference) {
+        int key = 0;
+        EXPECT_EQ(indexed_heap_key(&heap, h, &key), 0);
+        EXPECT_EQ(key, k);
+    }
+    indexed_heap_destroy(&heap);
+}
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "gtest.h"
+#include "kv_heap.h"
+
+namespace {
+struct Job {
+    int priority;
+    int id;
+};
+
+std::vector<Job> MakeJobs(int n) {
+    std::vector<Job> jobs;
+    for (int i = 0; i < n; ++i) {
+        jobs.push_back(Job{rand() % 2000 - 1000, i});
+    }
+    return jobs;
+}
+}  // namespace
+
+TEST(KvHeap, SoaPopsRecordsByKey) {
+    std::vector<Job> jobs = MakeJobs(1000);
+    kv_heap_t heap;
+    ASSERT_EQ(kv_heap_init(&heap, 0), 0);
+    for (auto& job : jobs) {
+        ASSERT_EQ(kv_heap_push(&heap, job.priority, &job), 0);
+    }
+    int last = INT_MIN;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        int key = 0;
+        void* payload = nullptr;
+        ASSERT_EQ(kv_heap_pop(&heap, &key, &payload), 0);
+        EXPECT_TRUE(key >= last);
+        EXPECT_EQ(static_cast<Job*>(payload)->priority, key);
+        last = key;
+    }
+    EXPECT_EQ(kv_heap_pop(&heap, nullptr, nullptr), -1);
+    kv_heap_destroy(&heap);
+}
+
+TEST(KvHeap, PackedPopsRecordsByKeyThenSlot) {
+    std::vector<Job> jobs = MakeJobs(1000);
+    jobs.push_back(Job{INT_MIN, 1000});
+    jobs.push_back(Job{INT_MAX, 1001});
+    kv_packed_heap_t heap;
+    ASSERT_EQ(kv_packed_heap_init(&heap, 4), 0);
+    for (auto& job : jobs) {
+        ASSERT_EQ(kv_packed_heap_push(&heap, job.priority, &job), 0);
+    }
+    std::vector<int> expected;
+    for (const auto& job : jobs) expected.push_back(job.priority);
+    std::sort(expected.begin(), expected.end());
+    std::vector<int> popped;
+    int key = 0;
+    void* payload = nullptr;
+    while (kv_packed_heap_pop(&heap, &key, &payload) == 0) {
+        EXPECT_EQ(static_cast<Job*>(payload)->priority, key);
+        popped.push_back(key);
+    }
+    EXPECT_TRUE(popped == expected);
+    kv_packed_heap_destroy(&heap);
+}
+
+TEST(KvHeap, PackedRecyclesSlots) {
+    kv_packed_heap_t heap;
+    ASSERT_EQ(kv_packed_heap_init(&heap, 0), 0);
+    int records[3] = {0, 1, 2};
+    for (int round = 0; round < 100; ++round) {
+        ASSERT_EQ(kv_packed_heap_push(&heap, round, &records[round % 3]), 0);
+        ASSERT_EQ(kv_packed_heap_push(&heap, round + 1, &records[(round + 1) % 3]), 0);
+        int key = -1;
+        void* payload = nullptr;
+        ASSERT_EQ(kv_packed_heap_pop(&heap, &key, &payload), 0);
+        EXPECT_EQ(key, round);
+        EXPECT_TRUE(payload == &records[round % 3]);
+        ASSERT_EQ(kv_packed_heap_pop(&heap, &key, &payload), 0);
+    }
+    EXPECT_EQ(heap.capacity, 10);
+    kv_packed_heap_destroy(&heap);
+}
@@ -0,0 +1,50 @@
+#include <cstdlib>
+#include <thread>
+#include "calculator.h"
+#include "gtest.h"
+
+TEST(MinHeapStats, CountsPushesAndReallocsOnTheCallingThread) {
+    min_heap_stats_t stats;
+    min_heap_stats_reset();
+    if (!min_heap_stats_enabled()) {
+        EXPECT_EQ(min_heap_stats_get(&stats), -1);
+        EXPECT_EQ(stats.pushes, 0ull);
+        return;
+    }
+    min_heap_t heap;
+    ASSERT_EQ(min_heap_init(&heap, 0, nullptr), 0);
+    for (int i = 1000; i > 0; --i) min_heap_push(&heap, i);
+    ASSERT_EQ(min_heap_stats_get(&stats), 0);
+    EXPECT_EQ(stats.pushes, 1000ull);
+    // Capacity 10 doubling to 1280: one alloc and seven resizes.
+    EXPECT_EQ(stats.reallocs, 8ull);
+    // Descending input moves every new value all the way to the root.
+    EXPECT_TRUE(stats.sift_up_levels > 0);
+    EXPECT_EQ(stats.swaps, stats.sift_up_levels);
+    EXPECT_TRUE(stats.comparisons >= stats.swaps);
+
+    int out = 0;
+    ASSERT_EQ(min_heap_pop(&heap, &out), 0);
+    EXPECT_EQ(out, 1);
+    min_heap_stats_t after;
+    min_heap_stats_get(&after);
+    EXPECT_TRUE(after.sift_down_levels > stats.sift_down_levels);
+    min_heap_destroy(&heap);
+
+    min_heap_stats_t other;
+    std::thread([&other] { min_heap_stats_get(&other); }).join();
+    EXPECT_EQ(other.pushes, 0ull);
+}
+
+TEST(MinHeapStats, LegacyInsertIsCounted) {
+    if (!min_heap_stats_enabled()) return;
+    min_heap_stats_reset();
+    int* data = nullptr;
+    int size = 0, capacity = 0;
+    for (int i = 0; i < 5; ++i) min_heap_insert(&data, &size, &capacity, i);
+    min_heap_stats_t stats;
+    min_heap_stats_get(&stats);
+    EXPECT_EQ(stats.pushes, 5ull);
+    EXPECT_EQ(stats.swaps, 0ull);
+    free(data);
+}
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "gtest.h"
+#include "multi_queue.h"
+#include "multi_queue.hpp"
+
+TEST(MultiQueue, SingleShardIsExact) {
+    multi_queue_int_t* queue = multi_queue_create(1);
+    ASSERT_TRUE(queue != nullptr);
+    const int values[] = {7, 3, 9, 1, 5};
+    for (int v : values) EXPECT_EQ(multi_queue_push(queue, v), 0);
+    const int expected[] = {1, 3, 5, 7, 9};
+    for (int e : expected) {
+        int value = -1;
+        EXPECT_EQ(multi_queue_pop(queue, &value), 0);
+        EXPECT_EQ(value, e);
+    }
+    int value = -1;
+    EXPECT_EQ(multi_queue_pop(queue, &value), -1);
+    multi_queue_destroy(queue);
+}
+
+TEST(MultiQueue, ConcurrentProducersAndConsumersKeepEveryElement) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 20000;
+    multi_queue<int> queue(2 * kThreads);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; ++t) {
+        producers.emplace_back([&queue, t] {
+            for (int i = 0; i < kPerThread; ++i) queue.push(t * kPerThread + i);
+        });
+    }
+    std::atomic<int> popped{0};
+    std::vector<std::vector<int>> seen(kThreads);
+    std::vector<std::thread> consumers;
+    for (int t = 0; t < kThreads; ++t) {
+        consumers.emplace_back([&, t] {
+            int value = 0;
+            while (popped.load() < kThreads * kPerThread) {
+                if (queue.try_pop(value)) {
+                    seen[t].push_back(value);
+                    popped.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& th : producers) th.join();
+    for (auto& th : consumers) th.join();
+    std::vector<int> all;
+    for (const auto& s : seen) all.insert(all.end(), s.begin(), s.end());
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), static_cast<size_t>(kThreads * kPerThread));
+    for (size_t i = 0; i < all.size(); ++i) {
+        if (all[i] != static_cast<int>(i)) {
+            EXPECT_EQ(all[i], static_cast<int>(i));
+            break;
+        }
+    }
+    int value = 0;
+    EXPECT_FALSE(queue.try_pop(value));
+}
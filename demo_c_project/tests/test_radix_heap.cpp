@@ -0,0 +1,59 @@
+#include <climits>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+#include "gtest.h"
+#include "radix_heap.h"
+
+TEST(RadixHeap, MatchesBinaryHeapOnMonotoneWorkload) {
+    radix_heap_t heap;
+    radix_heap_init(&heap);
+    std::priority_queue<int, std::vector<int>, std::greater<int>> reference;
+    std::mt19937 rng(testing::GetRandomSeed());
+    for (int i = 0; i < 1000; ++i) {
+        int key = static_cast<int>(rng() % 10000);
+        ASSERT_EQ(radix_heap_push(&heap, key), 0);
+        reference.push(key);
+    }
+    // Dijkstra-style: pop the minimum and push a few keys at or above it.
+    for (int step = 0; step < 20000 && !reference.empty(); ++step) {
+        int key = 0;
+        ASSERT_EQ(radix_heap_pop(&heap, &key), 0);
+        ASSERT_EQ(key, reference.top());
+        reference.pop();
+        for (unsigned k = rng() % 3; k > 0 && step < 15000; --k) {
+            int next = key + static_cast<int>(rng() % 10000);
+            ASSERT_EQ(radix_heap_push(&heap, next), 0);
+            reference.push(next);
+        }
+        EXPECT_EQ(heap.size, static_cast<int>(reference.size()));
+    }
+    int key = 0;
+    EXPECT_EQ(radix_heap_pop(&heap, &key), -1);
+    EXPECT_EQ(radix_heap_peek(&heap, &key), -1);
+    radix_heap_destroy(&heap);
+}
+
+TEST(RadixHeap, RejectsKeysBelowTheLastPopped) {
+    radix_heap_t heap;
+    radix_heap_init(&heap);
+    ASSERT_EQ(radix_heap_push(&heap, INT_MIN), 0);
+    ASSERT_EQ(radix_heap_push(&heap, -5), 0);
+    ASSERT_EQ(radix_heap_push(&heap, INT_MAX), 0);
+    ASSERT_EQ(radix_heap_push(&heap, 7), 0);
+    int key = 0;
+    EXPECT_EQ(radix_heap_pop(&heap, &key), 0);
+    EXPECT_EQ(key, INT_MIN);
+    EXPECT_EQ(radix_heap_peek(&heap, &key), 0);
+    EXPECT_EQ(key, -5);
+    EXPECT_EQ(radix_heap_push(&heap, -6), -1);
+    EXPECT_EQ(radix_heap_push(&heap, -5), 0);
+    const int expected[] = {-5, -5, 7, INT_MAX};
+    for (int e : expected) {
+        EXPECT_EQ(radix_heap_pop(&heap, &key), 0);
+        EXPECT_EQ(key, e);
+    }
+    EXPECT_EQ(heap.size, 0);
+    radix_heap_destroy(&heap);
+}
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+#include "gtest.h"
+#include "typed_heap.h"
+#include "typed_heap.hpp"
+
+struct event {
+    int64_t deadline;
+    int id;
+};
+
+struct by_deadline {
+    bool operator()(const event& a, const event& b) const { return a.deadline < b.deadline; }
+};
+
+extern "C" {
+TYPED_HEAP_DECLARE(event_heap, event)
+}
+TYPED_HEAP_DEFINE(event_heap, event, by_deadline)
+
+TEST(TypedHeap, Int64KeysAreNotTruncated) {
+    i64_min_heap_t heap;
+    ASSERT_EQ(i64_min_heap_init(&heap, 0), 0);
+    std::mt19937_64 rng(testing::GetRandomSeed());
+    std::vector<int64_t> values;
+    for (int i = 0; i < 2000; ++i) {
+        values.push_back(static_cast<int64_t>(rng()));
+        ASSERT_EQ(i64_min_heap_push(&heap, values.back()), 0);
+    }
+    values.push_back(std::numeric_limits<int64_t>::min());
+    values.push_back(-1);
+    ASSERT_EQ(i64_min_heap_push_many(&heap, values.data() + 2000, 2), 0);
+    std::sort(values.begin(), values.end());
+    int64_t top = 0;
+    EXPECT_EQ(i64_min_heap_peek(&heap, &top), 0);
+    EXPECT_EQ(top, values[0]);
+    std::vector<int64_t> drained;
+    int64_t value = 0;
+    while (i64_min_heap_pop(&heap, &value) == 0) drained.push_back(value);
+    EXPECT_TRUE(drained == values);
+    EXPECT_EQ(i64_min_heap_pop(&heap, &value), -1);
+    EXPECT_EQ(i64_min_heap_peek(&heap, &value), -1);
+    i64_min_heap_destroy(&heap);
+    EXPECT_TRUE(heap.data == nullptr);
+}
+
+TEST(TypedHeap, MaxHeapsAndFloatingPointKeys) {
+    const double values[] = {0.5, -1.0, 1e300, -0.0, 3.25, -1e-300};
+    f64_max_heap_t heap;
+    ASSERT_EQ(f64_max_heap_init(&heap, 4), 0);
+    ASSERT_EQ(f64_max_heap_push_many(&heap, values, 6), 0);
+    std::vector<double> expected(values, values + 6), drained;
+    std::sort(expected.begin(), expected.end(), std::greater<double>());
+    double value = 0;
+    while (f64_max_heap_pop(&heap, &value) == 0) drained.push_back(value);
+    EXPECT_TRUE(drained == expected);
+    f64_max_heap_destroy(&heap);
+
+    f32_min_heap_t scores;
+    ASSERT_EQ(f32_min_heap_init(&scores, 0), 0);
+    for (int i = 100; i > 0; --i) ASSERT_EQ(f32_min_heap_push(&scores, i * 0.25f), 0);
+    float score = 0;
+    EXPECT_EQ(f32_min_heap_pop(&scores, &score), 0);
+    EXPECT_EQ(score, 0.25f);
+    f32_min_heap_destroy(&scores);
+
+    i32_max_heap_t ints;
+    ASSERT_EQ(i32_max_heap_init(&ints, 0), 0);
+    const int32_t raw[] = {-1, 7, -1, 3};
+    ASSERT_EQ(i32_max_heap_push_many(&ints, raw, 4), 0);
+    int32_t top = 0;
+    EXPECT_EQ(i32_max_heap_pop(&ints, &top), 0);
+    EXPECT_EQ(top, 7);
+    i32_max_heap_destroy(&ints);
+}
+
+TEST(TypedHeap, CustomComparatorOrdersStructs) {
+    event_heap_t heap;
+    ASSERT_EQ(event_heap_init(&heap, 0), 0);
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_EQ(event_heap_push(&heap, event{(int64_t)((i * 7919) % 50) << 40, i}), 0);
+    }
+    event e{0, 0};
+    int64_t prev = -1;
+    int count = 0;
+    while (event_heap_pop(&heap, &e) == 0) {
+        EXPECT_TRUE(e.deadline > prev);
+        prev = e.deadline;
+        ++count;
+    }
+    EXPECT_EQ(count, 50);
+    event_heap_destroy(&heap);
+}
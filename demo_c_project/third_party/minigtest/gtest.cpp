@@ -1,14 +1,18 @@
 #include "gtest.h"
+#include "gtest_report.h"
 
 #include <chrono>
-#include <filesystem>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <sstream>
-
-namespace fs = std::filesystem;
+#include <thread>
 
 namespace testing {
 
@@ -20,10 +24,81 @@ std::vector<TestInfo>& Registry() {
 
 struct TestContext {
     std::vector<AssertionRecord> failures;
+    std::vector<std::pair<std::string, std::string>> properties;
+    uint32_t random_seed = 0;
+    bool random_seed_used = false;
 };
 
 thread_local TestContext* current_context = nullptr;
-std::string g_output_path;
+std::string g_output_spec;
+unsigned g_parallel = 0;
+std::string g_filter = "*";
+bool g_filter_given = false;
+int g_repeat = 1;
+bool g_server = false;
+uint32_t g_random_seed = 0;
+thread_local const void* current_param = nullptr;
+
+struct ParamTest {
+    std::string suite;
+    std::string name;
+    std::function<void()> body;
+};
+
+struct ParamInstantiationInfo {
+    std::string prefix;
+    std::string suite;
+    std::vector<std::string> names;
+    std::function<const void*(size_t)> param_at;
+};
+
+std::vector<ParamTest>& ParamTests() {
+    static std::vector<ParamTest> tests;
+    return tests;
+}
+
+std::vector<ParamInstantiationInfo>& ParamInstantiations() {
+    static std::vector<ParamInstantiationInfo> instantiations;
+    return instantiations;
+}
+
+// Appends one test per (TEST_P, value) pair to the registry. Deferred until
+// the run starts because TEST_P and INSTANTIATE_TEST_SUITE_P may be
+// registered in either order, from different translation units.
+void ExpandParamTests() {
+    static bool expanded = false;
+    if (expanded) return;
+    expanded = true;
+    for (const auto& inst : ParamInstantiations()) {
+        std::string suite = inst.prefix.empty() ? inst.suite : inst.prefix + "/" + inst.suite;
+        for (const auto& test : ParamTests()) {
+            if (test.suite != inst.suite) continue;
+            for (size_t i = 0; i < inst.names.size(); ++i) {
+                auto body = test.body;
+                auto param_at = inst.param_at;
+                Registry().push_back(TestInfo{suite, test.name + "/" + inst.names[i], [body, param_at, i] {
+                                                  current_param = param_at(i);
+                                                  body();
+                                              }});
+            }
+        }
+    }
+}
+
+// FNV-1a over the run seed and the test's full name.
+uint32_t TestSeed(const TestInfo& test) {
+    uint32_t h = 2166136261u ^ g_random_seed;
+    for (char c : test.suite + "." + test.name) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+unsigned DefaultParallelism() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
 }  // namespace
 
 TestRegistrar::TestRegistrar(const std::string& suite, const std::string& name, std::function<void()> func) {
@@ -40,110 +115,329 @@ void AddFailure(const std::string& file, int line, const std::string& message, b
     }
 }
 
+uint32_t GetRandomSeed() {
+    if (!current_context) return g_random_seed;
+    current_context->random_seed_used = true;
+    return current_context->random_seed;
+}
+
+void RecordProperty(const std::string& key, const std::string& value) {
+    if (current_context) current_context->properties.emplace_back(key, value);
+}
+
+namespace internal {
+const void* CurrentParam() {
+    return current_param;
+}
+
+void RegisterParamTest(const std::string& suite, const std::string& name, std::function<void()> body) {
+    ParamTests().push_back(ParamTest{suite, name, std::move(body)});
+}
+
+void RegisterParamInstantiation(const std::string& prefix, const std::string& suite, std::vector<std::string> names,
+                                std::function<const void*(size_t)> param_at) {
+    ParamInstantiations().push_back(ParamInstantiationInfo{prefix, suite, std::move(names), std::move(param_at)});
+}
+}  // namespace internal
+
+void ReportFalse(const char* expr, const char* file, int line, bool fatal) {
+    AddFailure(file, line, std::string("Expected: ") + expr + " is true", fatal);
+}
+
 void InitGoogleTest(int* argc, char** argv) {
+    g_parallel = DefaultParallelism();
+    g_random_seed = 0;
     for (int i = 1; i < *argc; ++i) {
         std::string arg(argv[i]);
-        std::string prefix = "--gtest_output=xml:";
+        // --gtest_output=xml[:path] or json[:path]; the report is streamed.
+        std::string prefix = "--gtest_output=";
         if (arg.rfind(prefix, 0) == 0) {
-            g_output_path = arg.substr(prefix.size());
+            g_output_spec = arg.substr(prefix.size());
+        }
+        // --gtest_parallel=N runs N tests at a time; 0 or no value means one
+        // per core (the default) and 1 runs them sequentially.
+        std::string parallel = "--gtest_parallel";
+        if (arg == parallel) {
+            g_parallel = DefaultParallelism();
+        } else if (arg.rfind(parallel + "=", 0) == 0) {
+            long n = std::strtol(arg.c_str() + parallel.size() + 1, nullptr, 10);
+            g_parallel = n > 0 ? static_cast<unsigned>(n) : DefaultParallelism();
+        }
+        std::string filter = "--gtest_filter=";
+        if (arg.rfind(filter, 0) == 0) {
+            g_filter = arg.substr(filter.size());
+            g_filter_given = true;
+        }
+        // --gtest_repeat=N reruns the selected tests N times; a negative count
+        // repeats forever.
+        std::string repeat = "--gtest_repeat=";
+        if (arg.rfind(repeat, 0) == 0) {
+            g_repeat = std::atoi(arg.c_str() + repeat.size());
+        }
+        // --gtest_random_seed=N fixes the seed behind GetRandomSeed(); 0 or
+        // no flag picks one from the clock.
+        std::string seed = "--gtest_random_seed=";
+        if (arg.rfind(seed, 0) == 0) {
+            g_random_seed = static_cast<uint32_t>(std::strtoul(arg.c_str() + seed.size(), nullptr, 10));
+        }
+        if (arg == "--gtest_server") {
+            g_server = true;
         }
     }
 }
 
-static void WriteXmlReport(const std::vector<TestInfo>& tests,
-                           const std::vector<std::vector<AssertionRecord>>& failures,
-                           const std::vector<double>& durations_ms) {
-    if (g_output_path.empty()) return;
+// Glob match as in googletest: '*' matches any string, '?' any character.
+static bool MatchesGlob(const char* pattern, const char* str) {
+    const char* star = nullptr;
+    const char* resume = nullptr;
+    while (*str) {
+        if (*pattern == '?' || *pattern == *str) {
+            ++pattern;
+            ++str;
+        } else if (*pattern == '*') {
+            star = pattern++;
+            resume = str;
+        } else if (star) {
+            pattern = star + 1;
+            str = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (*pattern == '*') ++pattern;
+    return *pattern == '\0';
+}
 
-    std::map<std::string, std::vector<size_t>> suite_map;
-    for (size_t i = 0; i < tests.size(); ++i) {
-        suite_map[tests[i].suite].push_back(i);
+static bool MatchesAny(const std::string& patterns, const std::string& name) {
+    size_t begin = 0;
+    while (begin <= patterns.size()) {
+        size_t end = patterns.find(':', begin);
+        if (end == std::string::npos) end = patterns.size();
+        if (MatchesGlob(patterns.substr(begin, end - begin).c_str(), name.c_str())) return true;
+        begin = end + 1;
     }
+    return false;
+}
 
-    fs::create_directories(fs::path(g_output_path).parent_path());
-    std::ofstream out(g_output_path);
-    if (!out.is_open()) {
-        std::cerr << "Warning: failed to write XML report to " << g_output_path << std::endl;
-        return;
+// Filter syntax follows googletest: "POSITIVE[-NEGATIVE]", each a
+// ':'-separated list of globs over "Suite.Name". An empty positive part means
+// "*".
+static bool PassesFilter(const std::string& filter, const std::string& name) {
+    size_t dash = filter.find('-');
+    std::string positive = filter.substr(0, dash);
+    if (positive.empty()) positive = "*";
+    if (!MatchesAny(positive, name)) return false;
+    return dash == std::string::npos || !MatchesAny(filter.substr(dash + 1), name);
+}
+
+static bool ReadShardEnv(const char* var, long* value) {
+    const char* env = std::getenv(var);
+    if (!env || !*env) return false;
+    *value = std::strtol(env, nullptr, 10);
+    return true;
+}
+
+// Applies the filter, then GTEST_TOTAL_SHARDS/GTEST_SHARD_INDEX: the N-th test
+// that passes the filter belongs to shard N % total. Returns false (after
+// printing why) if the shard variables are inconsistent.
+static bool SelectTests(const std::vector<TestInfo>& all, std::vector<TestInfo>* selected) {
+    // As in upstream gtest, GTEST_FILTER is only the default: an explicit
+    // --gtest_filter, even "*", takes precedence.
+    const char* env_filter = std::getenv("GTEST_FILTER");
+    std::string filter = !g_filter_given && env_filter ? env_filter : g_filter;
+    long total = 1, index = 0;
+    bool has_total = ReadShardEnv("GTEST_TOTAL_SHARDS", &total);
+    bool has_index = ReadShardEnv("GTEST_SHARD_INDEX", &index);
+    if (has_total != has_index || (has_total && (total < 1 || index < 0 || index >= total))) {
+        std::cerr << "Invalid environment variables: GTEST_TOTAL_SHARDS=" << (has_total ? total : -1)
+                  << ", GTEST_SHARD_INDEX=" << (has_index ? index : -1) << std::endl;
+        return false;
+    }
+    if (has_total) {
+        if (const char* status = std::getenv("GTEST_SHARD_STATUS_FILE")) {
+            std::ofstream(status).put('\n');
+        }
+    }
+    long counter = 0;
+    for (const auto& t : all) {
+        if (!PassesFilter(filter, t.suite + "." + t.name)) continue;
+        if (counter++ % total == index) selected->push_back(t);
     }
-    int total_failures = 0;
-    for (const auto& f : failures) total_failures += static_cast<int>(f.size());
-
-    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-    out << "<testsuites tests=\"" << tests.size() << "\" failures=\"" << total_failures
-        << "\" disabled=\"0\" errors=\"0\">\n";
-    for (const auto& [suite, indices] : suite_map) {
-        int suite_failures = 0;
-        for (size_t idx : indices) suite_failures += static_cast<int>(failures[idx].size());
-        double suite_time = 0.0;
-        for (size_t idx : indices) suite_time += durations_ms[idx] / 1000.0;
-        out << "  <testsuite name=\"" << suite << "\" tests=\"" << indices.size()
-            << "\" failures=\"" << suite_failures << "\" disabled=\"0\" errors=\"0\" time=\""
-            << suite_time << "\">\n";
-        for (size_t idx : indices) {
-            const auto& t = tests[idx];
-            out << "    <testcase name=\"" << t.name << "\" status=\"run\" result=\""
-                << (failures[idx].empty() ? "completed" : "failed") << "\" time=\""
-                << std::fixed << std::setprecision(3) << durations_ms[idx] / 1000.0
-                << "\" classname=\"" << suite << "\">";
-            if (!failures[idx].empty()) {
-                out << "\n";
-                for (const auto& fail : failures[idx]) {
-                    out << "      <failure message=\"" << fail.message << "\" type=\"\">\n";
-                    out << fail.file << ":" << fail.line << "\n";
-                    out << fail.message << "\n";
-                    out << "      </failure>\n";
-                }
-                out << "    </testcase>\n";
+    if (filter != "*") std::cout << "Note: Google Test filter = " << filter << std::endl;
+    if (has_total) std::cout << "Note: This is test shard " << index + 1 << " of " << total << "." << std::endl;
+    return true;
+}
+
+// Durations are kept in nanoseconds; the console prints milliseconds without
+// losing the nanosecond digits.
+static std::string FormatMillis(long long ns) {
+    std::ostringstream oss;
+    oss << ns / 1000000 << "." << std::setw(6) << std::setfill('0') << ns % 1000000;
+    return oss.str();
+}
+
+// Runs one test on the calling thread and renders its console lines into
+// result.log, so parallel runs can print them in registration order. With
+// `live` the RUN line goes straight to stdout before the test body instead,
+// so a test that crashes or hangs is still named on the console.
+static void RunTest(const TestInfo& test, internal::TestResult& result, bool live = false) {
+    if (live) std::cout << "[ RUN      ] " << test.suite << "." << test.name << std::endl;
+    TestContext ctx;
+    ctx.random_seed = TestSeed(test);
+    current_context = &ctx;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        test.func();
+    } catch (const AssertionException&) {
+        // fatal assertion handled
+    } catch (const std::exception& ex) {
+        AddFailure("unknown", 0, std::string("Unhandled exception: ") + ex.what(), true);
+    } catch (...) {
+        AddFailure("unknown", 0, "Unhandled non-standard exception", true);
+    }
+    auto end = std::chrono::steady_clock::now();
+    current_context = nullptr;
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    result.duration_ns = ns;
+    result.failures = std::move(ctx.failures);
+    result.properties = std::move(ctx.properties);
+
+    std::ostringstream out;
+    if (!live) out << "[ RUN      ] " << test.suite << "." << test.name << "\n";
+    for (const auto& prop : result.properties) {
+        out << "[   INFO   ] " << prop.first << " = " << prop.second << "\n";
+    }
+    if (result.failures.empty()) {
+        out << "[       OK ] " << test.suite << "." << test.name << " (" << FormatMillis(ns) << " ms)\n";
+    } else {
+        out << "[  FAILED  ] " << test.suite << "." << test.name << " (" << FormatMillis(ns) << " ms)\n";
+        for (const auto& f : result.failures) {
+            out << f.file << ":" << f.line << ": " << f.message << "\n";
+        }
+        if (ctx.random_seed_used) {
+            out << "Note: rerun with --gtest_random_seed=" << g_random_seed << " to reproduce.\n";
+        }
+    }
+    result.log = out.str();
+}
+
+// Work-stealing pool: test indices are dealt round-robin into per-worker
+// queues; a worker takes from the front of its own queue and steals from the
+// back of the others once it runs dry. Results go to per-index slots, and the
+// calling thread hands each finished test to `finish` as soon as every earlier
+// test has finished, so printing and reporting stay in registration order.
+class ParallelRunner {
+public:
+    ParallelRunner(const std::vector<TestInfo>& tests, std::vector<internal::TestResult>& results, unsigned workers)
+        : tests_(tests), results_(results), done_(tests.size(), 0), queues_(workers) {
+        for (size_t i = 0; i < tests.size(); ++i) queues_[i % workers].items.push_back(i);
+    }
+
+    void Run(const std::function<void(size_t)>& finish) {
+        std::vector<std::thread> threads;
+        for (size_t w = 0; w < queues_.size(); ++w) threads.emplace_back([this, w] { Work(w); });
+        for (size_t i = 0; i < tests_.size(); ++i) {
+            std::unique_lock<std::mutex> lock(done_mutex_);
+            done_cv_.wait(lock, [&] { return done_[i] != 0; });
+            lock.unlock();
+            finish(i);
+        }
+        for (auto& t : threads) t.join();
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> items;
+    };
+
+    bool Take(size_t self, size_t* index) {
+        for (size_t k = 0; k < queues_.size(); ++k) {
+            Queue& q = queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.items.empty()) continue;
+            if (k == 0) {
+                *index = q.items.front();
+                q.items.pop_front();
             } else {
-                out << "</testcase>\n";
+                *index = q.items.back();
+                q.items.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void Work(size_t self) {
+        size_t i;
+        while (Take(self, &i)) {
+            RunTest(tests_[i], results_[i]);
+            {
+                std::lock_guard<std::mutex> lock(done_mutex_);
+                done_[i] = 1;
             }
+            done_cv_.notify_one();
+        }
+    }
+
+    const std::vector<TestInfo>& tests_;
+    std::vector<internal::TestResult>& results_;
+    std::vector<char> done_;
+    std::mutex done_mutex_;
+    std::condition_variable done_cv_;
+    std::vector<Queue> queues_;
+};
+
+// Runs `tests` on g_parallel workers, calling `finish` in registration order.
+// `live_console` prints RUN lines as each test starts when running on one
+// worker; buffered output is kept for parallel runs and for server mode.
+static void RunSelection(const std::vector<TestInfo>& tests, std::vector<internal::TestResult>& results,
+                         const std::function<void(size_t)>& finish, bool live_console = false) {
+    unsigned workers = g_parallel;
+    if (workers > tests.size()) workers = static_cast<unsigned>(tests.size());
+    if (workers > 1) {
+        ParallelRunner(tests, results, workers).Run(finish);
+    } else {
+        for (size_t i = 0; i < tests.size(); ++i) {
+            RunTest(tests[i], results[i], live_console);
+            finish(i);
         }
-        out << "  </testsuite>\n";
     }
-    out << "</testsuites>\n";
 }
 
-int RunAllTests() {
-    const auto& tests = Registry();
+static int RunIteration(const std::vector<TestInfo>& tests) {
+    std::set<std::string> suites;
+    for (const auto& t : tests) suites.insert(t.suite);
     std::cout << "[==========] Running " << tests.size() << " tests from "
-              << tests.size() << " test suites." << std::endl;
+              << suites.size() << " test suites." << std::endl;
     std::cout << "[----------] Global test environment set-up." << std::endl;
 
+    std::unique_ptr<internal::StreamingReporter> reporter;
+    if (!g_output_spec.empty()) {
+        reporter = internal::StreamingReporter::Create(g_output_spec);
+        if (!reporter) {
+            std::cerr << "Warning: unrecognized output format \"" << g_output_spec << "\" ignored." << std::endl;
+        } else if (!reporter->Open()) {
+            reporter.reset();
+        }
+    }
+
+    // Each result is printed and reported as soon as it is in order, then its
+    // records are released; only the pass/fail flag is kept for the summary.
+    std::vector<internal::TestResult> results(tests.size());
+    std::vector<char> test_failed(tests.size(), 0);
     int failed = 0;
-    std::vector<std::vector<AssertionRecord>> failures(tests.size());
-    std::vector<double> durations_ms(tests.size(), 0.0);
-    for (size_t i = 0; i < tests.size(); ++i) {
-        const auto& test = tests[i];
-        std::cout << "[ RUN      ] " << test.suite << "." << test.name << std::endl;
-        TestContext ctx;
-        current_context = &ctx;
-        auto start = std::chrono::steady_clock::now();
-        try {
-            test.func();
-        } catch (const AssertionException&) {
-            // fatal assertion handled
-        } catch (const std::exception& ex) {
-            AddFailure("unknown", 0, std::string("Unhandled exception: ") + ex.what(), true);
-        } catch (...) {
-            AddFailure("unknown", 0, "Unhandled non-standard exception", true);
-        }
-        auto end = std::chrono::steady_clock::now();
-        double ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        durations_ms[i] = ms;
-        failures[i] = ctx.failures;
-        current_context = nullptr;
-
-        if (ctx.failures.empty()) {
-            std::cout << "[       OK ] " << test.suite << "." << test.name << " (" << ms << " ms)" << std::endl;
-        } else {
+    auto finish = [&](size_t i) {
+        std::cout << results[i].log << std::flush;
+        if (reporter) reporter->AddTest(tests[i], results[i]);
+        if (!results[i].failures.empty()) {
+            test_failed[i] = 1;
             ++failed;
-            std::cout << "[  FAILED  ] " << test.suite << "." << test.name << " (" << ms << " ms)" << std::endl;
-            for (const auto& f : ctx.failures) {
-                std::cout << f.file << ":" << f.line << ": " << f.message << std::endl;
-            }
         }
-    }
+        results[i] = internal::TestResult();
+    };
+    RunSelection(tests, results, finish, true);
+    if (reporter) reporter->Close();
 
     std::cout << "[----------] Global test environment tear-down" << std::endl;
     std::cout << "[==========] " << tests.size() << " tests ran." << std::endl;
@@ -151,14 +445,100 @@ int RunAllTests() {
     if (failed > 0) {
         std::cout << "[  FAILED  ] " << failed << " tests, listed below:" << std::endl;
         for (size_t i = 0; i < tests.size(); ++i) {
-            if (!failures[i].empty()) {
+            if (test_failed[i]) {
                 std::cout << "[  FAILED  ] " << tests[i].suite << "." << tests[i].name << std::endl;
             }
         }
     }
+    return failed;
+}
+
+// --gtest_server: reads one command per line from stdin and answers with one
+// JSON object per line on stdout, so a driver can rerun single tests without
+// spawning the binary again:
+//   run [FILTER]  runs the tests matching FILTER (default "*"), emitting a
+//                 {"event":"test",...} line per test and a final "done" line
+//   list          emits a {"event":"list","tests":[...]} line
+//   quit          exits (as does end of input)
+// Tests that write to stdout themselves interleave with the protocol.
+static void EmitServerResult(const TestInfo& test, const internal::TestResult& result) {
+    const auto& failures = result.failures;
+    std::ostringstream out;
+    out << "{\"event\":\"test\",\"suite\":\"" << internal::EscapeJson(test.suite) << "\",\"name\":\""
+        << internal::EscapeJson(test.name) << "\",\"status\":\"" << (failures.empty() ? "passed" : "failed")
+        << "\",\"time_ns\":" << result.duration_ns << ",\"failures\":[";
+    for (size_t i = 0; i < failures.size(); ++i) {
+        out << (i ? "," : "") << "{\"file\":\"" << internal::EscapeJson(failures[i].file)
+            << "\",\"line\":" << failures[i].line << ",\"fatal\":" << (failures[i].fatal ? "true" : "false")
+            << ",\"message\":\"" << internal::EscapeJson(failures[i].message) << "\"}";
+    }
+    out << "]}\n";
+    std::cout << out.str() << std::flush;
+}
+
+static int RunServer() {
+    const auto& all = Registry();
+    std::cout << "{\"event\":\"ready\",\"tests\":" << all.size() << "}" << std::endl;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream in(line);
+        std::string command, filter;
+        in >> command >> filter;
+        if (command.empty()) continue;
+        if (command == "quit") break;
+        if (command == "list") {
+            std::ostringstream out;
+            out << "{\"event\":\"list\",\"tests\":[";
+            for (size_t i = 0; i < all.size(); ++i) {
+                out << (i ? "," : "") << "\"" << internal::EscapeJson(all[i].suite + "." + all[i].name) << "\"";
+            }
+            out << "]}";
+            std::cout << out.str() << std::endl;
+            continue;
+        }
+        if (command != "run") {
+            std::cout << "{\"event\":\"error\",\"message\":\"unknown command: " << internal::EscapeJson(command)
+                      << "\"}" << std::endl;
+            continue;
+        }
+        if (filter.empty()) filter = "*";
+        std::vector<TestInfo> tests;
+        for (const auto& t : all) {
+            if (PassesFilter(filter, t.suite + "." + t.name)) tests.push_back(t);
+        }
+        std::vector<internal::TestResult> results(tests.size());
+        size_t failed = 0;
+        long long total_ns = 0;
+        RunSelection(tests, results, [&](size_t i) {
+            EmitServerResult(tests[i], results[i]);
+            failed += results[i].failures.empty() ? 0 : 1;
+            total_ns += results[i].duration_ns;
+            results[i] = internal::TestResult();
+        });
+        std::cout << "{\"event\":\"done\",\"tests\":" << tests.size() << ",\"failed\":" << failed
+                  << ",\"time_ns\":" << total_ns << "}" << std::endl;
+    }
+    return 0;
+}
 
-    WriteXmlReport(tests, failures, durations_ms);
-    return failed == 0 ? 0 : 1;
+int RunAllTests() {
+    if (g_random_seed == 0) {
+        auto now = std::chrono::system_clock::now().time_since_epoch().count();
+        g_random_seed = static_cast<uint32_t>(now % 99999) + 1;
+    }
+    ExpandParamTests();
+    if (g_server) return RunServer();
+    std::vector<TestInfo> tests;
+    if (!SelectTests(Registry(), &tests)) return 1;
+    std::cout << "Note: Random seed = " << g_random_seed << std::endl;
+    bool any_failed = false;
+    for (int iteration = 0; g_repeat < 0 || iteration < g_repeat; ++iteration) {
+        if (g_repeat != 1) {
+            std::cout << "\nRepeating all tests (iteration " << iteration + 1 << ") . . .\n\n";
+        }
+        any_failed |= RunIteration(tests) != 0;
+    }
+    return any_failed ? 1 : 0;
 }
 
 }  // namespace testing
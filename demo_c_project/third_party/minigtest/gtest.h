@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <functional>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace testing {
@@ -36,27 +41,144 @@ int RunAllTests();
 
 void AddFailure(const std::string& file, int line, const std::string& message, bool fatal);
 
-template <typename A, typename B>
-void ExpectEqual(const A& a, const B& b, const char* a_expr, const char* b_expr, const char* file, int line, bool fatal) {
-    if (a == b) return;
+// Seed for randomized tests, derived from --gtest_random_seed and the test's
+// full name, so a test sees the same value whichever tests run alongside it.
+// The run seed is printed at start-up, and failing tests that asked for a
+// seed print the flag that reproduces them.
+uint32_t GetRandomSeed();
+
+// Attaches key=value to the current test: printed with its result and written
+// as a property in the XML/JSON report.
+void RecordProperty(const std::string& key, const std::string& value);
+
+template <typename T>
+void RecordProperty(const std::string& key, const T& value) {
     std::ostringstream oss;
-    oss << "Expected equality of these values:\n  " << a_expr << "\n    Which is: " << a << "\n  " << b_expr << "\n    Which is: " << b;
-    AddFailure(file, line, oss.str(), fatal);
+    oss << value;
+    RecordProperty(key, oss.str());
 }
 
+// Value-parameterized tests, following googletest:
+//
+//   class HeapStress : public testing::TestWithParam<Case> {};
+//   TEST_P(HeapStress, PopsInOrder) { const Case& c = GetParam(); ... }
+//   INSTANTIATE_TEST_SUITE_P(Sizes, HeapStress, testing::Values(a, b, c));
+//
+// Each (test, value) pair becomes a test named Sizes/HeapStress.PopsInOrder/N;
+// an optional fourth argument maps a TestParamInfo<T> to the suffix instead.
+template <typename T>
+struct TestParamInfo {
+    const T& param;
+    size_t index;
+};
+
+namespace internal {
+const void* CurrentParam();
+void RegisterParamTest(const std::string& suite, const std::string& name, std::function<void()> body);
+void RegisterParamInstantiation(const std::string& prefix, const std::string& suite, std::vector<std::string> names,
+                                std::function<const void*(size_t)> param_at);
+
+struct ParamTestRegistrar {
+    ParamTestRegistrar(const std::string& suite, const std::string& name, std::function<void()> body) {
+        RegisterParamTest(suite, name, std::move(body));
+    }
+};
+
+template <typename... Ts>
+struct ValueList {
+    std::tuple<Ts...> values;
+
+    template <typename T>
+    std::vector<T> ToVector() const {
+        return std::apply([](const Ts&... v) { return std::vector<T>{static_cast<T>(v)...}; }, values);
+    }
+};
+
+template <typename T>
+class ParamInstantiation {
+public:
+    using NameFn = std::function<std::string(const TestParamInfo<T>&)>;
+
+    template <typename... Ts>
+    ParamInstantiation(const char* prefix, const char* suite, const ValueList<Ts...>& list, NameFn name = NameFn())
+        : ParamInstantiation(prefix, suite, list.template ToVector<T>(), std::move(name)) {}
+
+    ParamInstantiation(const char* prefix, const char* suite, std::vector<T> values, NameFn name = NameFn()) {
+        auto params = std::make_shared<std::vector<T>>(std::move(values));
+        std::vector<std::string> names;
+        for (size_t i = 0; i < params->size(); ++i) {
+            names.push_back(name ? name(TestParamInfo<T>{(*params)[i], i}) : std::to_string(i));
+        }
+        RegisterParamInstantiation(prefix, suite, std::move(names),
+                                   [params](size_t i) -> const void* { return &(*params)[i]; });
+    }
+};
+}  // namespace internal
+
+template <typename T>
+class TestWithParam {
+public:
+    using ParamType = T;
+    virtual ~TestWithParam() = default;
+    static const T& GetParam() { return *static_cast<const T*>(internal::CurrentParam()); }
+};
+
+template <typename... Ts>
+internal::ValueList<Ts...> Values(Ts... values) {
+    return {std::make_tuple(values...)};
+}
+
+template <typename Container>
+std::vector<typename Container::value_type> ValuesIn(const Container& c) {
+    return {c.begin(), c.end()};
+}
+
+template <typename T, size_t N>
+std::vector<T> ValuesIn(const T (&array)[N]) {
+    return {array, array + N};
+}
+
+#if defined(__GNUC__)
+#define GTEST_COLD_ __attribute__((cold, noinline))
+#define GTEST_LIKELY_(cond) __builtin_expect(!!(cond), 1)
+#elif defined(_MSC_VER)
+#define GTEST_COLD_ __declspec(noinline)
+#define GTEST_LIKELY_(cond) (cond)
+#else
+#define GTEST_COLD_
+#define GTEST_LIKELY_(cond) (cond)
+#endif
+
+// The failure reporters are kept out of line so a passing assertion inlines
+// to a compare and a not-taken branch, with no stream or string construction.
 template <typename A, typename B>
-void ExpectNotEqual(const A& a, const B& b, const char* a_expr, const char* b_expr, const char* file, int line, bool fatal) {
-    if (a != b) return;
+GTEST_COLD_ void ReportComparison(const char* relation, const A& a, const B& b, const char* a_expr,
+                                  const char* b_expr, const char* file, int line, bool fatal) {
     std::ostringstream oss;
-    oss << "Expected inequality of these values:\n  " << a_expr << "\n    Which is: " << a << "\n  " << b_expr << "\n    Which is: " << b;
+    oss << "Expected " << relation << " of these values:\n  " << a_expr << "\n    Which is: " << a << "\n  " << b_expr
+        << "\n    Which is: " << b;
     AddFailure(file, line, oss.str(), fatal);
 }
 
+GTEST_COLD_ void ReportFalse(const char* expr, const char* file, int line, bool fatal);
+
+template <typename A, typename B>
+inline void ExpectEqual(const A& a, const B& b, const char* a_expr, const char* b_expr, const char* file, int line,
+                        bool fatal) {
+    if (GTEST_LIKELY_(a == b)) return;
+    ReportComparison("equality", a, b, a_expr, b_expr, file, line, fatal);
+}
+
+template <typename A, typename B>
+inline void ExpectNotEqual(const A& a, const B& b, const char* a_expr, const char* b_expr, const char* file,
+                           int line, bool fatal) {
+    if (GTEST_LIKELY_(a != b)) return;
+    ReportComparison("inequality", a, b, a_expr, b_expr, file, line, fatal);
+}
+
 inline void ExpectTrue(bool cond, const char* expr, const char* file, int line, bool fatal) {
-    if (cond) return;
-    std::ostringstream oss;
-    oss << "Expected: " << expr << " is true";
-    AddFailure(file, line, oss.str(), fatal);
+    if (GTEST_LIKELY_(cond)) return;
+    ReportFalse(expr, file, line, fatal);
 }
 
 }  // namespace testing
@@ -66,6 +188,19 @@ inline void ExpectTrue(bool cond, const char* expr, const char* file, int line,
     static ::testing::TestRegistrar registrar_##Suite##_##Name(#Suite, #Name, &Suite##_##Name##_Test); \
     void Suite##_##Name##_Test()
 
+#define TEST_P(Suite, Name) \
+    class Suite##_##Name##_Test : public Suite { \
+    public: \
+        void TestBody(); \
+    }; \
+    static ::testing::internal::ParamTestRegistrar param_registrar_##Suite##_##Name( \
+        #Suite, #Name, [] { Suite##_##Name##_Test test; test.TestBody(); }); \
+    void Suite##_##Name##_Test::TestBody()
+
+#define INSTANTIATE_TEST_SUITE_P(Prefix, Suite, ...) \
+    static ::testing::internal::ParamInstantiation<Suite::ParamType> param_instantiation_##Prefix##_##Suite( \
+        #Prefix, #Suite, __VA_ARGS__)
+
 #define EXPECT_EQ(a, b) ::testing::ExpectEqual((a), (b), #a, #b, __FILE__, __LINE__, false)
 #define ASSERT_EQ(a, b) ::testing::ExpectEqual((a), (b), #a, #b, __FILE__, __LINE__, true)
 #define EXPECT_NE(a, b) ::testing::ExpectNotEqual((a), (b), #a, #b, __FILE__, __LINE__, false)
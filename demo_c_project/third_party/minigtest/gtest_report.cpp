@@ -0,0 +1,304 @@
+#include "gtest_report.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace testing {
+namespace internal {
+
+std::string EscapeJson(const std::string& text) {
+    std::string out;
+    out.reserve(text.size() + 2);
+    for (char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        case '\r': out += "\\r"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                out += buf;
+            } else {
+                out += c;
+            }
+            break;
+        }
+    }
+    return out;
+}
+
+namespace {
+
+// Width reserved for each totals field; the patched text is padded with
+// spaces, which both formats allow between attributes or tokens.
+constexpr size_t kFieldWidth = 112;
+
+std::string EscapeXml(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+        case '&': out += "&amp;"; break;
+        case '<': out += "&lt;"; break;
+        case '>': out += "&gt;"; break;
+        case '"': out += "&quot;"; break;
+        case '\n': out += "&#x0A;"; break;
+        default: out += c; break;
+        }
+    }
+    return out;
+}
+
+std::string EscapeXmlText(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+        case '&': out += "&amp;"; break;
+        case '<': out += "&lt;"; break;
+        case '>': out += "&gt;"; break;
+        default: out += c; break;
+        }
+    }
+    return out;
+}
+
+class XmlReporter : public StreamingReporter {
+public:
+    explicit XmlReporter(std::string path) : StreamingReporter(std::move(path)) {}
+
+protected:
+    std::pair<std::string, std::string> Header() override {
+        return {"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites ", ">\n"};
+    }
+
+    std::pair<std::string, std::string> SuiteHeader(const std::string& suite, bool) override {
+        return {"  <testsuite name=\"" + EscapeXml(suite) + "\" ", ">\n"};
+    }
+
+    std::string TotalsField(const Totals& totals, bool run_level) override {
+        std::ostringstream out;
+        out << "tests=\"" << totals.tests << "\" failures=\"" << totals.failures
+            << "\" disabled=\"0\" errors=\"0\" time=\"" << FormatSeconds(totals.duration_ns) << "\"";
+        if (run_level) out << " name=\"AllTests\"";
+        return out.str();
+    }
+
+    std::string SuiteFooter() override { return "  </testsuite>\n"; }
+
+    std::string TestEntry(const TestInfo& test, const TestResult& result, bool) override {
+        const auto& failures = result.failures;
+        std::ostringstream out;
+        out << "    <testcase name=\"" << EscapeXml(test.name) << "\" status=\"run\" result=\""
+            << (failures.empty() ? "completed" : "failed") << "\" time=\"" << FormatSeconds(result.duration_ns)
+            << "\" classname=\"" << EscapeXml(test.suite) << "\">";
+        if (!failures.empty() || !result.properties.empty()) {
+            out << "\n";
+            if (!result.properties.empty()) {
+                out << "      <properties>\n";
+                for (const auto& prop : result.properties) {
+                    out << "        <property name=\"" << EscapeXml(prop.first) << "\" value=\""
+                        << EscapeXml(prop.second) << "\"/>\n";
+                }
+                out << "      </properties>\n";
+            }
+            for (const auto& fail : failures) {
+                out << "      <failure message=\"" << EscapeXml(fail.message) << "\" type=\"\">\n";
+                out << EscapeXmlText(fail.file) << ":" << fail.line << "\n";
+                out << EscapeXmlText(fail.message) << "\n";
+                out << "      </failure>\n";
+            }
+            out << "    </testcase>\n";
+        } else {
+            out << "</testcase>\n";
+        }
+        return out.str();
+    }
+
+    std::string Trailer(bool suite_open) override {
+        return suite_open ? "  </testsuite>\n</testsuites>\n" : "</testsuites>\n";
+    }
+};
+
+// Same layout as googletest's JSON output.
+class JsonReporter : public StreamingReporter {
+public:
+    explicit JsonReporter(std::string path) : StreamingReporter(std::move(path)) {}
+
+protected:
+    std::pair<std::string, std::string> Header() override {
+        return {"{\n  ", "\n  \"name\": \"AllTests\",\n  \"testsuites\": ["};
+    }
+
+    std::pair<std::string, std::string> SuiteHeader(const std::string& suite, bool first_suite) override {
+        return {std::string(first_suite ? "" : ",") + "\n    {\n      \"name\": \"" + EscapeJson(suite) +
+                    "\",\n      ",
+                "\n      \"testsuite\": ["};
+    }
+
+    std::string TotalsField(const Totals& totals, bool) override {
+        std::ostringstream out;
+        out << "\"tests\": " << totals.tests << ", \"failures\": " << totals.failures
+            << ", \"disabled\": 0, \"errors\": 0, \"time\": \"" << FormatSeconds(totals.duration_ns) << "s\",";
+        return out.str();
+    }
+
+    std::string SuiteFooter() override { return "\n      ]\n    }"; }
+
+    std::string TestEntry(const TestInfo& test, const TestResult& result, bool first_in_suite) override {
+        const auto& failures = result.failures;
+        std::ostringstream out;
+        out << (first_in_suite ? "" : ",") << "\n        {\"name\": \"" << EscapeJson(test.name)
+            << "\", \"status\": \"RUN\", \"result\": \"COMPLETED\", \"time\": \""
+            << FormatSeconds(result.duration_ns) << "s\", \"classname\": \"" << EscapeJson(test.suite) << "\"";
+        // googletest emits recorded properties as extra string members.
+        for (const auto& prop : result.properties) {
+            out << ", \"" << EscapeJson(prop.first) << "\": \"" << EscapeJson(prop.second) << "\"";
+        }
+        if (!failures.empty()) {
+            out << ", \"failures\": [";
+            for (size_t i = 0; i < failures.size(); ++i) {
+                const auto& fail = failures[i];
+                out << (i ? ", " : "") << "{\"failure\": \""
+                    << EscapeJson(fail.file + ":" + std::to_string(fail.line) + "\n" + fail.message)
+                    << "\", \"type\": \"\"}";
+            }
+            out << "]";
+        }
+        out << "}";
+        return out.str();
+    }
+
+    std::string Trailer(bool suite_open) override { return std::string(suite_open ? "\n      ]\n    }" : "") + "\n  ]\n}\n"; }
+};
+
+}  // namespace
+
+class StreamingReporter::File {
+public:
+    explicit File(std::FILE* f) : f(f) { std::setvbuf(f, buffer, _IOFBF, sizeof(buffer)); }
+    ~File() {
+        if (f) std::fclose(f);
+    }
+
+    std::FILE* f;
+    long end = 0;
+    char buffer[1 << 16];
+};
+
+StreamingReporter::StreamingReporter(std::string path) : path_(std::move(path)) {}
+
+StreamingReporter::~StreamingReporter() = default;
+
+std::unique_ptr<StreamingReporter> StreamingReporter::Create(const std::string& spec) {
+    std::string format = spec.substr(0, spec.find(':'));
+    std::string path = spec.size() > format.size() ? spec.substr(format.size() + 1) : "";
+    if (path.empty() || path.back() == '/') path += "test_detail." + format;
+    if (format == "xml") return std::unique_ptr<StreamingReporter>(new XmlReporter(path));
+    if (format == "json") return std::unique_ptr<StreamingReporter>(new JsonReporter(path));
+    return nullptr;
+}
+
+std::string StreamingReporter::FormatSeconds(long long ns) {
+    std::ostringstream oss;
+    oss << ns / 1000000000 << "." << std::setw(9) << std::setfill('0') << ns % 1000000000;
+    return oss.str();
+}
+
+bool StreamingReporter::Open() {
+    fs::path parent = fs::path(path_).parent_path();
+    std::error_code ec;
+    if (!parent.empty()) fs::create_directories(parent, ec);
+    std::FILE* f = std::fopen(path_.c_str(), "wb");
+    if (!f) {
+        std::cerr << "Warning: failed to write report to " << path_ << std::endl;
+        return false;
+    }
+    file_.reset(new File(f));
+    run_totals_ = Totals();
+    auto header = Header();
+    Append(header.first);
+    AppendField(TotalsField(run_totals_, true), &run_field_);
+    Append(header.second);
+    Commit();
+    return true;
+}
+
+void StreamingReporter::AddTest(const TestInfo& test, const TestResult& result) {
+    if (!file_) return;
+    if (!suite_open_ || test.suite != suite_) {
+        if (suite_open_) Append(SuiteFooter());
+        auto header = SuiteHeader(test.suite, first_suite_);
+        Append(header.first);
+        suite_totals_ = Totals();
+        AppendField(TotalsField(suite_totals_, false), &suite_field_);
+        Append(header.second);
+        suite_ = test.suite;
+        suite_open_ = true;
+        first_suite_ = false;
+        first_in_suite_ = true;
+    }
+    Append(TestEntry(test, result, first_in_suite_));
+    first_in_suite_ = false;
+    for (Totals* t : {&run_totals_, &suite_totals_}) {
+        t->tests += 1;
+        t->failures += result.failures.size();
+        t->duration_ns += result.duration_ns;
+    }
+    PatchTotals();
+    Commit();
+}
+
+void StreamingReporter::Close() {
+    if (!file_) return;
+    Commit();
+    long size = file_->end + static_cast<long>(trailer_size_);
+    file_.reset();
+    // Earlier trailers were overwritten in place; drop anything past the last.
+    std::error_code ec;
+    fs::resize_file(path_, static_cast<std::uintmax_t>(size), ec);
+}
+
+void StreamingReporter::Append(const std::string& text) {
+    std::fwrite(text.data(), 1, text.size(), file_->f);
+    file_->end += static_cast<long>(text.size());
+}
+
+void StreamingReporter::AppendField(const std::string& text, long* offset) {
+    *offset = file_->end;
+    std::string padded = text;
+    padded.resize(kFieldWidth > text.size() ? kFieldWidth : text.size(), ' ');
+    Append(padded);
+}
+
+void StreamingReporter::Patch(long offset, const std::string& text) {
+    std::string padded = text;
+    padded.resize(kFieldWidth > text.size() ? kFieldWidth : text.size(), ' ');
+    std::fseek(file_->f, offset, SEEK_SET);
+    std::fwrite(padded.data(), 1, padded.size(), file_->f);
+    std::fseek(file_->f, file_->end, SEEK_SET);
+}
+
+void StreamingReporter::PatchTotals() {
+    Patch(run_field_, TotalsField(run_totals_, true));
+    Patch(suite_field_, TotalsField(suite_totals_, false));
+}
+
+void StreamingReporter::Commit() {
+    std::string trailer = Trailer(suite_open_);
+    std::fwrite(trailer.data(), 1, trailer.size(), file_->f);
+    std::fflush(file_->f);
+    std::fseek(file_->f, file_->end, SEEK_SET);
+    trailer_size_ = trailer.size();
+}
+
+}  // namespace internal
+}  // namespace testing
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest.h"
+
+namespace testing {
+namespace internal {
+
+std::string EscapeJson(const std::string& text);
+
+// Outcome of one test run, filled on the worker thread that ran it.
+struct TestResult {
+    std::vector<AssertionRecord> failures;
+    std::vector<std::pair<std::string, std::string>> properties;
+    long long duration_ns = 0;
+    std::string log;
+};
+
+// Writes the XML or JSON report incrementally while tests run. Each result is
+// appended as soon as it is known, and the totals sit in fixed-width fields
+// near the top that are patched in place. After each test the closing tags are
+// written and flushed, then overwritten by the next append, so the file on
+// disk is a complete report even if the run crashes midway.
+class StreamingReporter {
+public:
+    virtual ~StreamingReporter();
+
+    // `spec` is the part after --gtest_output=: "xml[:path]" or "json[:path]".
+    // Returns null for unknown formats.
+    static std::unique_ptr<StreamingReporter> Create(const std::string& spec);
+
+    bool Open();
+    void AddTest(const TestInfo& test, const TestResult& result);
+    void Close();
+
+    const std::string& path() const { return path_; }
+
+protected:
+    struct Totals {
+        size_t tests = 0;
+        size_t failures = 0;
+        long long duration_ns = 0;
+    };
+
+    explicit StreamingReporter(std::string path);
+
+    // Text before and after the totals field of the run and of a suite.
+    virtual std::pair<std::string, std::string> Header() = 0;
+    virtual std::pair<std::string, std::string> SuiteHeader(const std::string& suite, bool first_suite) = 0;
+    // Text of the patched totals field, for the whole run or one suite.
+    virtual std::string TotalsField(const Totals& totals, bool run_level) = 0;
+    virtual std::string SuiteFooter() = 0;
+    virtual std::string TestEntry(const TestInfo& test, const TestResult& result, bool first_in_suite) = 0;
+    virtual std::string Trailer(bool suite_open) = 0;
+
+    static std::string FormatSeconds(long long ns);
+
+private:
+    class File;
+
+    void Append(const std::string& text);
+    void AppendField(const std::string& text, long* offset);
+    void Patch(long offset, const std::string& text);
+    void Commit();
+    void PatchTotals();
+
+    std::string path_;
+    std::unique_ptr<File> file_;
+    size_t trailer_size_ = 0;
+    long run_field_ = -1;
+    long suite_field_ = -1;
+    bool suite_open_ = false;
+    bool first_in_suite_ = true;
+    bool first_suite_ = true;
+    std::string suite_;
+    Totals run_totals_;
+    Totals suite_totals_;
+};
+
+}  // namespace internal
+}  // namespace testing